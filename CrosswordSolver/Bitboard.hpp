@@ -0,0 +1,133 @@
+/// @file Bitboard.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 9/13/2022
+/// @brief
+///     Bitmask view of a crossword board for CrossSolver.cpp. Each row and
+/// column keeps one mask of vacant cells and one of cells filled across or
+/// down, so finding line starts, line lengths and whether the board is full
+/// are shifts, ANDs and bit scans instead of neighbour-by-neighbour checks.
+///
+/// @note Expects ROWS and COLS to be defined by the including file. Bit c of
+/// a row mask is column c; bit r of a column mask is row r.
+
+#ifndef BITBOARD_HPP_
+#define BITBOARD_HPP_
+
+#include <cstdint>
+
+struct bitboard_t {
+    using mask_t = std::uint32_t;
+
+    static_assert(ROWS <= 32 && COLS <= 32, "board does not fit in a mask_t");
+
+    mask_t open_row[ROWS] {};    // vacant (not '+') cells of each row
+    mask_t open_col[COLS] {};    // vacant (not '+') cells of each col
+    mask_t across_row[ROWS] {};  // cells of each row filled by an across word
+    mask_t down_row[ROWS] {};    // cells of each row filled by a down word
+    mask_t down_col[COLS] {};    // cells of each col filled by a down word
+
+    // rebuild every mask from a board and its line state
+    void load(char board[][COLS], char state[][COLS]) {
+        for (unsigned r = 0; r < ROWS; ++r) {
+            open_row[r] = across_row[r] = down_row[r] = 0;
+        }
+
+        for (unsigned c = 0; c < COLS; ++c) {
+            open_col[c] = down_col[c] = 0;
+        }
+
+        for (unsigned r = 0; r < ROWS; ++r) {
+            for (unsigned c = 0; c < COLS; ++c) {
+                if (board[r][c] != '+') {
+                    open_row[r] |= (mask_t)1 << c;
+                    open_col[c] |= (mask_t)1 << r;
+                }
+
+                if ((state[r][c] & 'h') == 'h') {
+                    across_row[r] |= (mask_t)1 << c;
+                }
+
+                if ((state[r][c] & 'v') == 'v') {
+                    down_row[r] |= (mask_t)1 << c;
+                    down_col[c] |= (mask_t)1 << r;
+                }
+            }
+        }
+    }
+
+    // cells of row r starting an across line: vacant, edge or '+' to the
+    // left, vacant to the right
+    mask_t across_starts(unsigned r) const {
+        mask_t open = open_row[r];
+        return open & ~(open << 1) & (open >> 1);
+    }
+
+    // cells of row r starting a down line: vacant, edge or '+' above,
+    // vacant below
+    mask_t down_starts(unsigned r) const {
+        mask_t above = r ? open_row[r-1] : 0;
+        mask_t below = r + 1 < ROWS ? open_row[r+1] : 0;
+        return open_row[r] & ~above & below;
+    }
+
+    // across / down starts of row r not yet filled in that direction
+    mask_t open_across(unsigned r) const {
+        return across_starts(r) & ~across_row[r];
+    }
+
+    mask_t open_down(unsigned r) const {
+        return down_starts(r) & ~down_row[r];
+    }
+
+    // number of vacant cells from (r, c) in direction 'dir'
+    unsigned length(unsigned r, unsigned c, char dir) const {
+        mask_t open = dir == 'h' ? open_row[r] >> c : open_col[c] >> r;
+        return (unsigned)__builtin_ctz(~open);
+    }
+
+    // mark a word of 'len' cells from (r, c) in direction 'dir' as filled
+    void place(unsigned r, unsigned c, unsigned len, char dir) {
+        mask_t run = (mask_t)((1ULL << len) - 1);
+
+        if (dir == 'h') {
+            across_row[r] |= run << c;
+            return;
+        }
+
+        down_col[c] |= run << r;
+
+        for (unsigned i = 0; i < len; ++i) {
+            down_row[r + i] |= (mask_t)1 << c;
+        }
+    }
+
+    // undo place()
+    void remove(unsigned r, unsigned c, unsigned len, char dir) {
+        mask_t run = (mask_t)((1ULL << len) - 1);
+
+        if (dir == 'h') {
+            across_row[r] &= ~(run << c);
+            return;
+        }
+
+        down_col[c] &= ~(run << r);
+
+        for (unsigned i = 0; i < len; ++i) {
+            down_row[r + i] &= ~((mask_t)1 << c);
+        }
+    }
+
+    // whether every line holds a word in its own direction; a line whose
+    // cells are all covered by crossing words still needs one
+    bool settled() const {
+        mask_t open = 0;  // line starts still waiting for a word
+
+        for (unsigned r = 0; r < ROWS; ++r) {
+            open |= open_across(r) | open_down(r);
+        }
+
+        return !open;
+    }
+};
+
+#endif  // BITBOARD_HPP_
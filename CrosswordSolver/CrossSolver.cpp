@@ -7,47 +7,191 @@
 /// words to use.
 
 #include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
 
+#include <unistd.h>
+
 const unsigned ROWS = 10;  // max num of rows in the board
 const unsigned COLS = 10;  // max num of cols in the board
 
 /// @brief
-/// Counts the length of a vertical or horizontal line starting at (r, c)
-///
-/// @param board : the board of characters to count from
-/// @param r : the row index to start from
-/// @param c : the col index to start from
-/// @param dir : the direction ('h' -> horizontal, 'v' -> vertical) to count in
-///
-/// @note Stops counting when reaching the edge of the board or when encountering
-/// a '+' character, indicating a non-vacancy.
-///
-/// @returns the length of the line segment starting at (r, c)
+/// A horizontal or vertical line of two or more vacancies to place a word in.
+
+struct slot_t {
+    unsigned r;     // row index of the first cell
+    unsigned c;     // col index of the first cell
+    unsigned len;   // number of cells in the line
+    char dir;       // 'h' -> horizontal, 'v' -> vertical
+};
+
+/// @brief
+/// A small edit to an already-solved puzzle.
+
+struct delta_t {
+    char kind;          // 'c' -> cell edit, 'w' -> word swap
+    unsigned r;         // row index of the edited cell
+    unsigned c;         // col index of the edited cell
+    char value;         // new cell value ('+' or '-')
+    std::string from;   // word taken out of the words list
+    std::string to;     // word put into the words list
+};
+
+/// @brief
+/// Bookkeeping for one randomized, node-limited run of solve().
+
+struct search_t {
+    std::mt19937_64 rng;        // tie-breaking and word order randomness
+    unsigned long nodes;        // calls to solve() made in this run
+    unsigned long limit;        // calls allowed before the run is abandoned
+    bool aborted;               // whether the run hit its limit
+};
+
+/// @brief
+/// One daemon session: the last puzzle received with its solution, and the
+/// request being read.
+/*
+    request:            response:
+    SOLVE               SOLVED | UNSOLVED | ERROR <reason>
+    <puzzle file>       <board rows, omitted on ERROR>
+    END                 END
+
+    CELL <r> <c> <+|->  (edits the last puzzle and repairs its solution
+    END                 with resolve(); same response as SOLVE)
+
+    SWAP <old> <new>
+    END
+
+    QUIT                (closes the session)
+*/
+
+struct daemon_session_t {
+    char puzzle[ROWS][COLS];        // unsolved board of the last puzzle
+    char board[ROWS][COLS];         // crossword board data
+    char state[ROWS][COLS];         // crossword line state data
+    std::vector<std::string> words; // words list of the last puzzle
+    bool loaded;                    // whether a puzzle has been sent yet
+    bool framing;                   // whether a request is being read
+    std::string command;            // first line of the request
+    std::string request;            // body of the request
+
+    // read one request line, answering each request it completes; false
+    // on QUIT
+    bool take(const std::string& line, std::string& reply);
+
+    // answer a request left unterminated by the end of the input
+    void finish(std::string& reply);
+
+    // answer the request just read
+    void answer(bool closed, std::string& reply);
+};
 
-unsigned vacantLen(char board[][COLS], unsigned r, unsigned c, char dir);
+const unsigned long RESTART_BASE = 64;  // node limit per unit of the schedule
+
+// restart settings, fixed by main() before any puzzle is solved
+bool use_restarts = false;      // solve through solve_restarts()
+unsigned long restart_seed{};   // seed of every restarted search
+
+#include "../LineServer.hpp"
+#include "Bitboard.hpp"
+#include "PuzzleIO.hpp"
+#include "WordPool.hpp"
+
+const unsigned LINE_LEN = ROWS > COLS ? ROWS : COLS;  // longest line
 
 /// @brief
 /// Recursively backtracks to solve a crossword puzzle using a board of
 /// characters, a list of words, and a parallel board keeping track of how
 /// each vacancy has been visited.
 ///
-/// @param words : the list of words to place into the board
+/// @param words : the pool of words to place into the board
 /// @param board : the board to fill blank lines in from
 /// @param state : keeps track of whether a position has been visited in either
 ///   a horizontal or vertical pass; important for detecting shared positions
 ///   between words
 ///
+/// @param search : when given, the next line is chosen among those with the
+///   fewest fitting words (ties broken at random), words are tried in random
+///   order, and the search gives up once its node limit is reached
+/// @param bits : bitmask view of 'board' and 'state', kept in step with them
+///   by each placement; built from them when not given
+///
 /// @returns whether the recursive word path could be solved given
 ///   the current state of the board and words list:
 ///     'TRUE' if it could be
 ///     'FALSE' if it couldn't be
 
-bool solve(std::vector<std::string>& words, char board[][COLS],
-           char state[][COLS]);
+bool solve(word_pool_t& words, char board[][COLS], char state[][COLS],
+           search_t* search = nullptr, bitboard_t* bits = nullptr);
+
+/// @brief
+/// Copies the current letters of a line into a contiguous buffer.
+///
+/// @param board : the board to read from
+/// @param r : the row index of the first cell
+/// @param c : the col index of the first cell
+/// @param len : the number of cells in the line
+/// @param dir : the direction ('h' -> horizontal, 'v' -> vertical) of the line
+/// @param line : receives 'len' characters
+
+void read_line(char board[][COLS], unsigned r, unsigned c, unsigned len,
+               char dir, char line[]);
+
+/// @brief
+/// Tests whether a word agrees with every letter already in a line.
+///
+/// @param word : the first of 'len' letters of the word
+/// @param line : the line as read by read_line()
+/// @param len : the length of both
+///
+/// @returns whether the word can be placed in the line
+
+bool fits_line(const char* word, const char line[], unsigned len);
+
+/// @brief
+/// Returns the i-th term (from 1) of the Luby restart sequence:
+/// 1 1 2 1 1 2 4 1 1 2 1 1 2 4 8 ...
+///
+/// @param i : the index of the term
+
+unsigned long luby(unsigned long i);
+
+/// @brief
+/// Solves a puzzle with a series of randomized runs of solve(), each allowed
+/// RESTART_BASE times the next Luby term of nodes, so that an unlucky early
+/// choice is abandoned instead of searched to exhaustion.
+///
+/// @param words : the pool of words to place into the board
+/// @param board : the board to fill blank lines in from
+/// @param state : the line state of the board
+/// @param seed : the seed of the random choices; equal seeds repeat a run
+///
+/// @returns whether the puzzle could be solved (a run that finishes without
+///   reaching its limit proves it cannot be)
+
+bool solve_restarts(word_pool_t& words, char board[][COLS],
+                    char state[][COLS], unsigned long seed);
+
+/// @brief
+/// Solves a puzzle with the strategy chosen on the command line.
+///
+/// @param words : the list of words to place into the board; left holding
+///   the words which were not placed
+/// @param board : the board to fill blank lines in from
+/// @param state : the line state of the board
+///
+/// @returns whether the puzzle could be solved
+
+bool solve_puzzle(std::vector<std::string>& words, char board[][COLS],
+                  char state[][COLS]);
 
 /// @brief
 /// Prints the current values of the board in a ROWS x COLS grid of characters.
@@ -68,11 +212,149 @@ bool solve(std::vector<std::string>& words, char board[][COLS],
 */
 void print_puzzle(char board[][COLS]);
 
-int main() {
-    std::ifstream infile;               // input file stream
+/// @brief
+/// Lists every line of two or more vacancies in the board, in the same
+/// row-major order solve() visits them.
+///
+/// @param board : the board to collect lines from
+///
+/// @returns the list of lines
+
+std::vector<slot_t> find_slots(char board[][COLS]);
+
+/// @brief
+/// Checks a delta against the puzzle it would edit: a cell edit must name a
+/// cell of the board and a '+' or '-', and a word swap a listed word.
+///
+/// @param words : the words list of the puzzle
+/// @param delta : the cell edit or word swap to check
+///
+/// @returns whether the delta can be applied
+
+bool valid_delta(const std::vector<std::string>& words, const delta_t& delta);
+
+/// @brief
+/// Applies a delta to a solved puzzle and repairs the solution, touching as
+/// few lines as possible.
+///
+/// @param words : the words list, updated with the delta
+/// @param board : the unsolved board, updated with the delta
+/// @param solution : the previous solution, replaced by the repaired one
+/// @param delta : the cell edit or word swap to apply
+///
+/// @note Lines whose previous word is still available and which do not
+/// contain the edited cell are kept. The remaining lines are searched first;
+/// if that fails, every line connected to them is searched, and if that fails
+/// too the whole puzzle is solved from scratch.
+///
+/// @returns whether the edited puzzle could be solved:
+///     'TRUE' if it could be ('solution' holds the new fill)
+///     'FALSE' if it couldn't be, or the delta is invalid ('words', 'board'
+///     and 'solution' are left unchanged)
+
+bool resolve(std::vector<std::string>& words, char board[][COLS],
+             char solution[][COLS], const delta_t& delta);
+
+/// @brief
+/// Reads a puzzle (ROWS x COLS board followed by the words list) from an
+/// input stream.
+///
+/// @param input : the stream to read the puzzle from
+/// @param board : the board to populate
+/// @param state : the state board to reset
+/// @param words : the words list to populate
+///
+/// @returns whether a complete board could be read from the stream
+
+bool read_puzzle(std::istream& input, char board[][COLS], char state[][COLS],
+                 std::vector<std::string>& words);
+
+/// @brief
+/// Solves every puzzle file given and writes all of the results with a
+/// single write to standard output.
+///
+/// @param files : the paths of the puzzle files
+/// @param count : the number of paths
+///
+/// @returns the number of puzzles which could not be read or solved
+
+int solve_batch(char* files[], int count);
+
+/// @brief
+/// Times the stream-based parser and printer against the buffered ones over
+/// the given puzzle files and reports the average cost of each.
+///
+/// @param files : the paths of the puzzle files
+/// @param count : the number of paths
+
+void bench_io(char* files[], int count);
+
+int main(int argc, char* argv[]) {
+    const char* USAGE = "usage: CrossSolver [--restarts | --seed <n>] "
+                        "[--serve | --socket <path> | --batch <files...> | "
+                        "--bench <files...>]\n";
+
+    // leading options: --restarts (random seed) or --seed <n> (fixed seed)
+    while (argc > 1 && argv[1][0] == '-' && argv[1][1] == '-') {
+        std::string option = argv[1];  // option being consumed
+
+        if (option == "--restarts") {
+            use_restarts = true;
+            restart_seed = std::random_device{}();
+            std::cerr << "restart seed: " << restart_seed << '\n';
+        } else if (option == "--seed") {
+            char* end = nullptr;  // first character not part of the seed
+
+            errno = 0;
+
+            // strtoull() would accept a sign
+            if (argc > 2 && std::isdigit((unsigned char)argv[2][0])) {
+                restart_seed = std::strtoull(argv[2], &end, 10);
+            }
+
+            if (!end || *end || errno == ERANGE) {
+                std::cerr << USAGE;
+                return 1;
+            }
+
+            use_restarts = true;
+            --argc;
+            ++argv;
+        } else {
+            break;
+        }
+
+        --argc;
+        ++argv;
+    }
+
+    // daemon modes: keep the process warm and answer framed requests
+    if (argc > 1) {
+        std::string mode = argv[1];  // requested run mode
+
+        if (mode == "--serve") {
+            daemon_session_t session{};
+
+            return serve_stream(session, STDIN_FILENO, STDOUT_FILENO) ? 0
+                                                                       : 1;
+        } else if (mode == "--socket" && argc > 2) {
+            return serve_socket(argv[2], [] { return daemon_session_t{}; });
+        } else if (mode == "--batch" && argc > 2) {
+            return solve_batch(argv + 2, argc - 2) ? 1 : 0;
+        } else if (mode == "--bench" && argc > 2) {
+            bench_io(argv + 2, argc - 2);
+            return 0;
+        }
+
+        std::cerr << USAGE;
+        return 1;
+    }
+
+    file_view_t infile;                 // loaded input file
     std::string filename;               // name of input file
+    std::string output;                 // formatted board
+    bool opened = false;                // whether the input file is loaded
     std::vector<std::string> words {};  // words list
-    std::string word;                   // word string for input to words list
 
     char board[ROWS][COLS];             // crossword board data
     char state[ROWS][COLS];             // crossword line state data
@@ -84,58 +366,56 @@ int main() {
     do {
         std::cin  >> filename;
 
-        infile.open(filename);
+        opened = infile.open(filename.c_str());
 
-        if (!infile.is_open()) {
+        if (!opened) {
             std::cout << "The file could not be opened. Try again: ";
         }
-    } while (!infile.is_open());
+    } while (!opened);
 
-    // populate board from input file
-    for (unsigned r = 0; r < ROWS; ++r) {
-        for (unsigned c = 0; c < COLS; ++c) {
-            state[r][c] = '\0';
-            infile >> board[r][c];      // '-' => vacant, '+' => non-vacant
-        }
-    }
-
-    // populate words list from input file
-    while (infile >> word) {
-        words.push_back(word);
-    }
+    // populate board and words list from input file
+    parse_puzzle(infile.data, infile.data + infile.size, board, state, words);
 
     // attempt to solve the crossword using the words list
-    bool result = solve(words, board, state);  // is the puzzle solvable?
+    bool result = solve_puzzle(words, board, state);  // is it solvable?
     
     if (!result) {
         std::cout << "Puzzle could not be solved." << std::endl;
     }
     
-    std::cout << '\n';
-    print_puzzle(board);
+    output = "\n";
+    format_puzzle(output, board);
+    std::cout << std::flush;
+    write_buffer(STDOUT_FILENO, output);
 
     return 0;
 }
 
-unsigned vacantLen(char board[][COLS], unsigned r, unsigned c, char dir) {
-    unsigned count{};
-
-    while (board[r][c] != '+' && r != ROWS && c != COLS) {
-        count++;
-        r += (dir == 'v' ? 1 : 0);
-        c += (dir == 'h' ? 1 : 0);
+bool solve(word_pool_t& words, char board[][COLS], char state[][COLS],
+           search_t* search, bitboard_t* bits) {
+    // the masks are built once per search and updated with every placement
+    if (!bits) {
+        bitboard_t local;
+        local.load(board, state);
+        return solve(words, board, state, search, &local);
     }
 
-    return count;
-}
-
-bool solve(std::vector<std::string>& words, char board[][COLS],
-           char state[][COLS]) {
     // out of words to use
-    if (!words.size()) {
+    if (words.empty()) {
         return true;
     }
 
+    // words remain but every line already holds a word
+    if (bits->settled()) {
+        return false;
+    }
+
+    // out of nodes for this run
+    if (search && ++search->nodes > search->limit) {
+        search->aborted = true;
+        return false;
+    }
+
     // else, find a blank starting point:
     // horizontal: vacant and non-vacant left and vacant right
     // vertical: vacant and non-vacant up and vacant down
@@ -144,123 +424,219 @@ bool solve(std::vector<std::string>& words, char board[][COLS],
 
     unsigned r{}, c{}, len{};
     char dir{};
+    char line[LINE_LEN];  // current letters of a line, '-' where vacant
+
+    if (search) {
+        // most constrained line first, ties broken at random
+        std::size_t best = words.remaining + 1;  // fewest fitting words seen
+        unsigned long ties = 0;                  // lines sharing that count
+
+        for (unsigned sr = 0; sr < ROWS; ++sr) {
+            bitboard_t::mask_t down = bits->open_down(sr);
+            bitboard_t::mask_t across = bits->open_across(sr);
+
+            for (auto starts = down | across; starts; starts &= starts - 1) {
+                unsigned sc = (unsigned)__builtin_ctz(starts);
+
+                for (char sdir : {'v', 'h'}) {
+                    if (!(((sdir == 'v' ? down : across) >> sc) & 1)) {
+                        continue;
+                    }
+
+                    unsigned slen = bits->length(sr, sc, sdir);
+                    std::size_t fits = 0;  // words that fit this line
+
+                    read_line(board, sr, sc, slen, sdir, line);
 
-    while (!found_spot) {
-        for (c = 0; !found_spot && c < COLS; c += !found_spot) {
-            if (
-                board[r][c] != '+' &&                   // not non-vacant
-                ((r != 0 && board[r-1][c] == '+') ||    // non-vacant or
-                r == 0) &&                              // edge above
-                r != ROWS-1 && board[r+1][c] != '+' &&  // vacant below
-                (state[r][c] & 'v') != 'v'              // not vert. checked
-            ) {
-                // vertical start
-                found_spot = true;
-                dir = 'v';
-            } else if (
-                board[r][c] != '+' &&                   // not non-vacant
-                ((c != 0 && board[r][c-1] == '+') ||    // non-vacant or
-                c == 0) &&                              // edge left
-                c != COLS-1 && board[r][c+1] != '+' &&  // vacant right
-                (state[r][c] & 'h') != 'h'              // not horiz. checked
-            ) {
-                // horizontal start
-                found_spot = true;
-                dir = 'h';
+                    for (auto w = words.begin(slen); w < words.end(slen); ++w) {
+                        fits += words.count[w] && fits_line(words.word(w),
+                                                            line, slen);
+                    }
+
+                    if (fits < best) {
+                        best = fits;
+                        ties = 0;
+                    }
+
+                    if (fits == best && search->rng() % ++ties == 0) {
+                        found_spot = true;
+                        r = sr;
+                        c = sc;
+                        dir = sdir;
+                    }
+                }
             }
         }
+    }
+
+    while (!search && !found_spot && r < ROWS) {
+        bitboard_t::mask_t down = bits->open_down(r);
+        bitboard_t::mask_t across = bits->open_across(r);
+
+        // first start of the row; vertical before horizontal on the same cell
+        if (down | across) {
+            found_spot = true;
+            c = (unsigned)__builtin_ctz(down | across);
+            dir = ((down >> c) & 1) ? 'v' : 'h';
+        }
 
         r += !found_spot;
     }
 
-    // get length of line
-    len = vacantLen(board, r, c, dir);
+    // words remain but every line is already filled
+    if (!found_spot) {
+        return false;
+    }
 
-    // collect all words whose length == len
-    auto iter = words.begin();  // iterator over words vector
+    // get length and current letters of line
+    len = bits->length(r, c, dir);
+    read_line(board, r, c, len, dir, line);
 
-    std::vector<std::string> poss{};
+    // collect all unused words whose length == len and which fit the line
+    std::vector<std::uint32_t> poss{};
 
-    while (iter != words.end()) {
-        if (iter->length() == len) {
-            poss.push_back(*iter);
+    for (auto w = words.begin(len); w < words.end(len); ++w) {
+        if (words.count[w] && fits_line(words.word(w), line, len)) {
+            poss.push_back(w);
         }
-
-        ++iter;
     }
 
-    // if there are no words to pick, the puzzle cannot be solved from here
-    if (!poss.size()) {
-        return false;
+    if (search) {
+        std::shuffle(poss.begin(), poss.end(), search->rng);
     }
 
     unsigned offsR = (dir == 'v' ? 1 : 0);  // vertical offset from (r, c)
     unsigned offsC = (dir == 'h' ? 1 : 0);  // horizontal offset from (r, c)
 
-    while (poss.size()) {
-        // check the next possibility
-        std::string word = *poss.begin();
+    // try each possibility; with none, the puzzle cannot be solved from here
+    for (std::uint32_t w : poss) {
+        const char* word = words.word(w);
 
-        // check if it fits (false if so, true otherwise)
-        bool fault = false;
+        // remove it from words
+        words.take(w);
 
-        for (unsigned i = 0; !fault && i < word.length(); ++i) {
-            if (
-                board[r + i * offsR][c + i * offsC] != '-' &&
-                board[r + i * offsR][c + i * offsC] != word.at(i)
-            ) {
-                fault = true;
-            }
+        // add it to the board
+        for (unsigned i = 0; i < len; ++i) {
+            board[r + i * offsR][c + i * offsC] = word[i];
+            state[r + i * offsR][c + i * offsC] |= dir;
         }
 
-        // if the word couldn't fit, try the next word
-        if (fault) {
-            poss.erase(poss.begin(), poss.begin() + 1);
-        // otherwise, if the word fits,
-        } else {
-            // remove it from words
-            auto w_pos = std::find(words.begin(), words.end(), word);
-            words.erase(w_pos, w_pos + 1);
-
-            // add it to the board
-            for (unsigned i = 0; i < word.length(); ++i) {
-                board[r + i * offsR][c + i * offsC] = word.at(i);
-                state[r + i * offsR][c + i * offsC] |= dir;
-            }
+        bits->place(r, c, len, dir);
 
-            // if the current word choice does not work down the chain,
-            if (!solve(words, board, state)) {
-                // add it back to words
-                words.insert(w_pos, word);
-
-                // remove it from board
-                for (unsigned i = 0; i < word.length(); ++i) {
-                    // if only visited in current direction of travel
-                    if ((state[r + i * offsR][c + i * offsC] ^= dir) == '\0') {
-                        // reset to empty
-                        board[r + i * offsR][c + i * offsC] = '-';
-                    // otherwise it is an intersection of two words
-                    } else {
-                        // keep char but reset state to other direction
-                        state[r + i * offsR][c + i * offsC] |=
-                            (dir == 'h' ? 'v' : 'h');
-                    }
-                }
+        // if the current word choice works down the chain,
+        if (solve(words, board, state, search, bits)) {
+            // pass success back up the call stack
+            return true;
+        }
+
+        // otherwise add it back to words
+        words.give(w);
 
-                // remove it from possibilities
-                poss.erase(poss.begin(), poss.begin() + 1);
-            // otherwise if it does work,
+        // remove it from board
+        for (unsigned i = 0; i < len; ++i) {
+            // if only visited in current direction of travel
+            if ((state[r + i * offsR][c + i * offsC] ^= dir) == '\0') {
+                // reset to empty
+                board[r + i * offsR][c + i * offsC] = '-';
+            // otherwise it is an intersection of two words
             } else {
-                // pass success back up the call stack
-                return true;
+                // keep char but reset state to other direction
+                state[r + i * offsR][c + i * offsC] |=
+                    (dir == 'h' ? 'v' : 'h');
             }
         }
+
+        bits->remove(r, c, len, dir);
+
+        // a run out of nodes abandons every remaining choice
+        if (search && search->aborted) {
+            return false;
+        }
     }
 
-    // if poss is now empty, then we cannot solve from the parent choice
+    // if poss is exhausted, then we cannot solve from the parent choice
     return false;
 }
 
+void read_line(char board[][COLS], unsigned r, unsigned c, unsigned len,
+               char dir, char line[]) {
+    unsigned offsR = (dir == 'v' ? 1 : 0);  // vertical offset from (r, c)
+    unsigned offsC = (dir == 'h' ? 1 : 0);  // horizontal offset from (r, c)
+
+    for (unsigned i = 0; i < len; ++i) {
+        line[i] = board[r + i * offsR][c + i * offsC];
+    }
+}
+
+bool fits_line(const char* word, const char line[], unsigned len) {
+    for (unsigned i = 0; i < len; ++i) {
+        if (line[i] != '-' && line[i] != word[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+unsigned long luby(unsigned long i) {
+    unsigned k = 1;  // smallest k with 2^k - 1 >= i
+
+    while ((1UL << k) - 1 < i) {
+        ++k;
+    }
+
+    if ((1UL << k) - 1 == i) {
+        return 1UL << (k - 1);
+    }
+
+    return luby(i - (1UL << (k - 1)) + 1);
+}
+
+bool solve_restarts(word_pool_t& words, char board[][COLS],
+                    char state[][COLS], unsigned long seed) {
+    search_t search{std::mt19937_64(seed), 0, 0, false};
+
+    char work[ROWS][COLS];   // board of the current run
+    char trail[ROWS][COLS];  // line state of the current run
+
+    for (unsigned long run = 1; ; ++run) {
+        word_pool_t pool = words;  // words of the current run
+
+        std::copy(&board[0][0], &board[0][0] + ROWS * COLS, &work[0][0]);
+        std::copy(&state[0][0], &state[0][0] + ROWS * COLS, &trail[0][0]);
+
+        search.nodes = 0;
+        search.limit = luby(run) * RESTART_BASE;
+        search.aborted = false;
+
+        if (solve(pool, work, trail, &search)) {
+            std::copy(&work[0][0], &work[0][0] + ROWS * COLS, &board[0][0]);
+            std::copy(&trail[0][0], &trail[0][0] + ROWS * COLS, &state[0][0]);
+            words = pool;
+            return true;
+        } else if (!search.aborted) {
+            return false;
+        }
+    }
+}
+
+bool solve_puzzle(std::vector<std::string>& words, char board[][COLS],
+                  char state[][COLS]) {
+    word_pool_t pool;  // words grouped by length
+    bool result;       // whether the puzzle was solved
+
+    pool.build(words);
+
+    if (use_restarts) {
+        result = solve_restarts(pool, board, state, restart_seed);
+    } else {
+        result = solve(pool, board, state);
+    }
+
+    words = pool.list();
+    return result;
+}
+
 void print_puzzle(char board[][COLS]) {
     for (unsigned r = 0; r < ROWS; ++r) {
         for (unsigned c = 0; c < COLS; ++c) {
@@ -269,3 +645,423 @@ void print_puzzle(char board[][COLS]) {
         std::cout << std::endl;
     }
 }
+
+std::vector<slot_t> find_slots(char board[][COLS]) {
+    std::vector<slot_t> slots{};
+    char state[ROWS][COLS] {};  // no line filled yet
+    bitboard_t bits;            // masks of 'board'
+
+    bits.load(board, state);
+
+    for (unsigned r = 0; r < ROWS; ++r) {
+        bitboard_t::mask_t down = bits.down_starts(r);
+        bitboard_t::mask_t across = bits.across_starts(r);
+
+        for (auto starts = down | across; starts; starts &= starts - 1) {
+            unsigned c = (unsigned)__builtin_ctz(starts);
+
+            if ((down >> c) & 1) {
+                slots.push_back({r, c, bits.length(r, c, 'v'), 'v'});
+            }
+
+            if ((across >> c) & 1) {
+                slots.push_back({r, c, bits.length(r, c, 'h'), 'h'});
+            }
+        }
+    }
+
+    return slots;
+}
+
+/// @brief
+/// Fills the lines not marked as kept, leaving kept lines fixed to their
+/// previous words.
+///
+/// @param words : the full words list of the puzzle
+/// @param board : the unsolved board
+/// @param slots : every line of the board
+/// @param prior : the previous word of each kept line
+/// @param keep : whether each line keeps its previous word
+/// @param solution : receives the fill on success
+///
+/// @returns whether the unkept lines could be filled
+
+static bool fill_slots(const std::vector<std::string>& words,
+                       char board[][COLS], const std::vector<slot_t>& slots,
+                       const std::vector<std::string>& prior,
+                       const std::vector<bool>& keep, char solution[][COLS]) {
+    char work[ROWS][COLS];                  // board being filled
+    char state[ROWS][COLS];                 // line state of 'work'
+    std::vector<std::string> rest = words;  // words left for unkept lines
+
+    std::copy(&board[0][0], &board[0][0] + ROWS * COLS, &work[0][0]);
+    std::fill(&state[0][0], &state[0][0] + ROWS * COLS, '\0');
+
+    // pin kept lines exactly as solve() would have left them
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+        if (!keep[s]) {
+            continue;
+        }
+
+        unsigned offsR = (slots[s].dir == 'v' ? 1 : 0);
+        unsigned offsC = (slots[s].dir == 'h' ? 1 : 0);
+
+        for (unsigned i = 0; i < slots[s].len; ++i) {
+            work[slots[s].r + i * offsR][slots[s].c + i * offsC] = prior[s][i];
+            state[slots[s].r + i * offsR][slots[s].c + i * offsC] |=
+                slots[s].dir;
+        }
+
+        rest.erase(std::find(rest.begin(), rest.end(), prior[s]));
+    }
+
+    if (!solve_puzzle(rest, work, state)) {
+        return false;
+    }
+
+    std::copy(&work[0][0], &work[0][0] + ROWS * COLS, &solution[0][0]);
+    return true;
+}
+
+bool valid_delta(const std::vector<std::string>& words, const delta_t& delta) {
+    if (delta.kind == 'c') {
+        return delta.r < ROWS && delta.c < COLS &&
+               (delta.value == '+' || delta.value == '-');
+    }
+
+    return std::find(words.begin(), words.end(), delta.from) != words.end();
+}
+
+bool resolve(std::vector<std::string>& words, char board[][COLS],
+             char solution[][COLS], const delta_t& delta) {
+    if (!valid_delta(words, delta)) {
+        return false;
+    }
+
+    char cell = '\0';       // edited cell before the delta
+    std::size_t w_index = 0;  // index of the swapped word
+
+    // apply the delta to the puzzle itself
+    if (delta.kind == 'c') {
+        cell = board[delta.r][delta.c];
+        board[delta.r][delta.c] = delta.value;
+    } else {
+        w_index = (std::size_t)(std::find(words.begin(), words.end(),
+                                          delta.from) - words.begin());
+        words[w_index] = delta.to;
+    }
+
+    std::vector<slot_t> slots = find_slots(board);
+    std::vector<std::string> prior(slots.size());  // previous word per line
+    std::vector<bool> keep(slots.size(), false);   // line keeps its word
+    std::vector<std::string> pool = words;         // words not yet kept
+
+    // keep every line whose old word is complete, untouched and still listed
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+        unsigned offsR = (slots[s].dir == 'v' ? 1 : 0);
+        unsigned offsC = (slots[s].dir == 'h' ? 1 : 0);
+        bool touched = false;  // line covers the edited cell
+
+        for (unsigned i = 0; i < slots[s].len; ++i) {
+            unsigned r = slots[s].r + i * offsR;
+            unsigned c = slots[s].c + i * offsC;
+
+            touched |= (delta.kind == 'c' && r == delta.r && c == delta.c);
+            prior[s] += solution[r][c];
+        }
+
+        auto w_pos = std::find(pool.begin(), pool.end(), prior[s]);
+
+        if (!touched && w_pos != pool.end()) {
+            pool.erase(w_pos);
+            keep[s] = true;
+        }
+    }
+
+    // (1) local repair: only the lines that lost their word
+    if (fill_slots(words, board, slots, prior, keep, solution)) {
+        return true;
+    }
+
+    // (2) release every line connected to a repaired line through crossings
+    std::vector<int> owner(ROWS * COLS * 2, -1);  // line at (cell, dir)
+
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+        for (unsigned i = 0; i < slots[s].len; ++i) {
+            unsigned r = slots[s].r + i * (slots[s].dir == 'v' ? 1 : 0);
+            unsigned c = slots[s].c + i * (slots[s].dir == 'h' ? 1 : 0);
+
+            owner[(r * COLS + c) * 2 + (slots[s].dir == 'v')] = (int)s;
+        }
+    }
+
+    std::vector<std::size_t> frontier{};  // released lines left to expand
+
+    for (std::size_t s = 0; s < slots.size(); ++s) {
+        if (!keep[s]) {
+            frontier.push_back(s);
+        }
+    }
+
+    while (frontier.size()) {
+        slot_t line = slots[frontier.back()];
+        frontier.pop_back();
+
+        for (unsigned i = 0; i < line.len; ++i) {
+            unsigned r = line.r + i * (line.dir == 'v' ? 1 : 0);
+            unsigned c = line.c + i * (line.dir == 'h' ? 1 : 0);
+            int cross = owner[(r * COLS + c) * 2 + (line.dir != 'v')];
+
+            if (cross >= 0 && keep[cross]) {
+                keep[cross] = false;
+                frontier.push_back((std::size_t)cross);
+            }
+        }
+    }
+
+    if (fill_slots(words, board, slots, prior, keep, solution)) {
+        return true;
+    }
+
+    // (3) full search from scratch
+    std::fill(keep.begin(), keep.end(), false);
+
+    if (fill_slots(words, board, slots, prior, keep, solution)) {
+        return true;
+    }
+
+    // take the delta back out of the puzzle
+    if (delta.kind == 'c') {
+        board[delta.r][delta.c] = cell;
+    } else {
+        words[w_index] = delta.from;
+    }
+
+    return false;
+}
+
+bool read_puzzle(std::istream& input, char board[][COLS], char state[][COLS],
+                 std::vector<std::string>& words) {
+    std::string word;  // word string for input to words list
+
+    words.clear();
+
+    for (unsigned r = 0; r < ROWS; ++r) {
+        for (unsigned c = 0; c < COLS; ++c) {
+            state[r][c] = '\0';
+            board[r][c] = '+';
+
+            if (!(input >> board[r][c])) {  // '-' => vacant, '+' => non-vacant
+                return false;
+            }
+        }
+    }
+
+    while (input >> word) {
+        words.push_back(word);
+    }
+
+    return true;
+}
+
+bool daemon_session_t::take(const std::string& line, std::string& reply) {
+    if (framing) {
+        if (line == "END") {
+            framing = false;
+            answer(true, reply);
+        } else {
+            request += line;
+            request += '\n';
+        }
+    } else if (line == "QUIT") {
+        return false;
+    } else if (!line.empty()) {
+        command = line;
+        request.clear();
+        framing = true;
+    }
+
+    return true;
+}
+
+void daemon_session_t::finish(std::string& reply) {
+    if (framing) {
+        framing = false;
+        answer(false, reply);
+    }
+}
+
+void daemon_session_t::answer(bool closed, std::string& reply) {
+    std::istringstream args(command);  // command keyword and arguments
+    std::string keyword;               // command keyword
+    std::string status;                // first line of the response
+    delta_t delta{};                   // edit requested by CELL / SWAP
+
+    args >> keyword;
+
+    if (keyword == "CELL") {
+        delta.kind = 'c';
+        args >> delta.r >> delta.c >> delta.value;
+    } else if (keyword == "SWAP") {
+        delta.kind = 'w';
+        args >> delta.from >> delta.to;
+    }
+
+    if (!closed) {
+        status = "ERROR unterminated request\n";
+    } else if (keyword == "SOLVE") {
+        if (!parse_puzzle(request.data(), request.data() + request.size(),
+                          puzzle, state, words)) {
+            loaded = false;
+            status = "ERROR incomplete board\n";
+        } else {
+            std::copy(&puzzle[0][0], &puzzle[0][0] + ROWS * COLS,
+                      &board[0][0]);
+
+            // solve() consumes the words it places, so solve a copy
+            std::vector<std::string> pool = words;
+
+            loaded = true;
+            status = solve_puzzle(pool, board, state) ? "SOLVED\n"
+                                                      : "UNSOLVED\n";
+        }
+    } else if (delta.kind == 0) {
+        status = "ERROR unknown command " + keyword + "\n";
+    } else if (!loaded) {
+        status = "ERROR no puzzle to edit\n";
+    } else if (!args) {
+        status = "ERROR malformed " + keyword + "\n";
+    } else if (!valid_delta(words, delta)) {
+        status = delta.kind == 'c' ? "ERROR bad cell\n"
+                                   : "ERROR unknown word\n";
+    } else {
+        status = resolve(words, puzzle, board, delta) ? "SOLVED\n"
+                                                       : "UNSOLVED\n";
+    }
+
+    reply += status;
+
+    if (status[0] != 'E') {
+        format_puzzle(reply, board);
+    }
+
+    reply += "END\n";
+}
+
+int solve_batch(char* files[], int count) {
+    file_view_t infile;                 // loaded input file
+    std::string output;                 // results of every puzzle
+    std::vector<std::string> words {};  // words list
+    int failures = 0;                   // puzzles not read or solved
+
+    char board[ROWS][COLS];             // crossword board data
+    char state[ROWS][COLS];             // crossword line state data
+
+    for (int i = 0; i < count; ++i) {
+        output += files[i];
+
+        if (
+            !infile.open(files[i]) ||
+            !parse_puzzle(infile.data, infile.data + infile.size, board,
+                          state, words)
+        ) {
+            output += ": could not be read\n";
+            ++failures;
+            continue;
+        }
+
+        if (solve_puzzle(words, board, state)) {
+            output += ": solved\n";
+        } else {
+            output += ": could not be solved\n";
+            ++failures;
+        }
+
+        format_puzzle(output, board);
+        output += '\n';
+    }
+
+    write_buffer(STDOUT_FILENO, output);
+
+    return failures;
+}
+
+void bench_io(char* files[], int count) {
+    using clock = std::chrono::steady_clock;
+
+    const unsigned REPEAT = 2000;       // passes over the file list
+
+    std::vector<std::string> words {};  // words list
+    char board[ROWS][COLS];             // crossword board data
+    char state[ROWS][COLS];             // crossword line state data
+    std::size_t checksum = 0;           // keeps the work observable
+
+    // stream path: ifstream + operator>>, one character at a time
+    auto start = clock::now();
+
+    for (unsigned n = 0; n < REPEAT; ++n) {
+        for (int i = 0; i < count; ++i) {
+            std::ifstream infile(files[i]);
+
+            read_puzzle(infile, board, state, words);
+            checksum += words.size() + (unsigned char)board[ROWS-1][COLS-1];
+        }
+    }
+
+    double stream_parse = std::chrono::duration<double, std::nano>(
+        clock::now() - start).count() / (REPEAT * count);
+
+    // buffered path: whole-file load + pointer scan
+    file_view_t infile;
+
+    start = clock::now();
+
+    for (unsigned n = 0; n < REPEAT; ++n) {
+        for (int i = 0; i < count; ++i) {
+            infile.open(files[i]);
+            parse_puzzle(infile.data, infile.data + infile.size, board, state,
+                         words);
+            checksum += words.size() + (unsigned char)board[ROWS-1][COLS-1];
+        }
+    }
+
+    double buffer_parse = std::chrono::duration<double, std::nano>(
+        clock::now() - start).count() / (REPEAT * count);
+
+    // both writers go to /dev/null so only the formatting and calls are timed
+    std::ofstream sink("/dev/null");
+    std::streambuf* saved = std::cout.rdbuf(sink.rdbuf());
+
+    start = clock::now();
+
+    for (unsigned n = 0; n < REPEAT; ++n) {
+        print_puzzle(board);
+    }
+
+    double stream_write = std::chrono::duration<double, std::nano>(
+        clock::now() - start).count() / REPEAT;
+
+    std::cout.rdbuf(saved);
+
+    int null_fd = ::open("/dev/null", O_WRONLY);
+    std::string output;
+
+    start = clock::now();
+
+    for (unsigned n = 0; n < REPEAT; ++n) {
+        output.clear();
+        format_puzzle(output, board);
+        write_buffer(null_fd, output);
+    }
+
+    double buffer_write = std::chrono::duration<double, std::nano>(
+        clock::now() - start).count() / REPEAT;
+
+    ::close(null_fd);
+
+    std::cout << "parse  stream: " << stream_parse << " ns/puzzle\n"
+              << "parse  buffer: " << buffer_parse << " ns/puzzle\n"
+              << "write  stream: " << stream_write << " ns/board\n"
+              << "write  buffer: " << buffer_write << " ns/board\n"
+              << "(checksum " << checksum << ")" << std::endl;
+}
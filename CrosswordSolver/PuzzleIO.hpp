@@ -0,0 +1,189 @@
+/// @file PuzzleIO.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 9/13/2022
+/// @brief
+///     Buffered puzzle parsing and board output for CrossSolver.cpp. A puzzle
+/// file is loaded whole (read or memory mapped) and scanned with pointer
+/// arithmetic, and boards are formatted into a single buffer which is written
+/// with one call (write_buffer() in LineServer.hpp).
+///
+/// @note Expects ROWS and COLS to be defined by the including file.
+
+#ifndef PUZZLE_IO_HPP_
+#define PUZZLE_IO_HPP_
+
+#include <cerrno>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// @brief
+/// Read-only view of a whole file. Small files are read with a single read()
+/// into a buffer reused from open to open; large files are memory mapped.
+
+struct file_view_t {
+    static const std::size_t MMAP_MIN = 1 << 16;  // smallest file to map
+
+    const char* data = nullptr;  // first byte of the file
+    std::size_t size = 0;        // number of bytes in the file
+    bool mapped = false;         // whether 'data' is a mapping
+    std::string buffer;          // storage for files read, not mapped
+
+    file_view_t() = default;
+    file_view_t(const file_view_t&) = delete;
+    file_view_t& operator=(const file_view_t&) = delete;
+
+    ~file_view_t() { close(); }
+
+    // view the file at 'path', replacing any previous view
+    bool open(const char* path) {
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        struct stat info{};
+
+        if (fd < 0) {
+            return false;
+        } else if (::fstat(fd, &info) < 0 || !S_ISREG(info.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+
+        std::size_t len = (std::size_t)info.st_size;  // bytes to view
+
+        if (len >= MMAP_MIN) {
+            void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+
+            data = (const char*)addr;
+            mapped = true;
+        } else {
+            std::size_t got = 0;  // bytes read so far
+
+            buffer.resize(len);
+
+            while (got < len) {
+                ssize_t part = ::read(fd, &buffer[got], len - got);
+
+                if (part < 0 && errno == EINTR) {
+                    continue;
+                } else if (part <= 0) {
+                    break;
+                }
+
+                got += (std::size_t)part;
+            }
+
+            len = got;
+            data = buffer.data();
+        }
+
+        ::close(fd);
+        size = len;
+        return true;
+    }
+
+    void close() {
+        if (mapped) {
+            ::munmap((void*)data, size);
+        }
+
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
+};
+
+/// @brief
+/// Whitespace test matching the one used by stream extraction.
+
+inline bool is_blank(char ch) {
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' ||
+           ch == '\v' || ch == '\f';
+}
+
+/// @brief
+/// Parses a puzzle (ROWS x COLS board followed by the words list) from a
+/// range of characters, accepting exactly what read_puzzle() accepts.
+///
+/// @param first : the first character of the puzzle text
+/// @param last : one past the last character of the puzzle text
+/// @param board : the board to populate
+/// @param state : the state board to reset
+/// @param words : the words list to populate
+///
+/// @returns whether a complete board could be read from the range
+
+inline bool parse_puzzle(const char* first, const char* last,
+                         char board[][COLS], char state[][COLS],
+                         std::vector<std::string>& words) {
+    const char* p = first;  // scan position
+
+    words.clear();
+
+    for (unsigned r = 0; r < ROWS; ++r) {
+        for (unsigned c = 0; c < COLS; ++c) {
+            while (p != last && is_blank(*p)) {
+                ++p;
+            }
+
+            state[r][c] = '\0';
+            board[r][c] = '+';
+
+            if (p == last) {
+                return false;
+            }
+
+            board[r][c] = *p++;  // '-' => vacant, '+' => non-vacant
+        }
+    }
+
+    while (true) {
+        while (p != last && is_blank(*p)) {
+            ++p;
+        }
+
+        if (p == last) {
+            break;
+        }
+
+        const char* start = p;  // first character of the word
+
+        while (p != last && !is_blank(*p)) {
+            ++p;
+        }
+
+        words.emplace_back(start, (std::size_t)(p - start));
+    }
+
+    return true;
+}
+
+/// @brief
+/// Appends the rows of the board, each ending with a newline, to a buffer.
+///
+/// @param out : the buffer to append to
+/// @param board : the board to format
+
+inline void format_puzzle(std::string& out, char board[][COLS]) {
+    std::size_t at = out.size();  // where the board starts in the buffer
+
+    out.resize(at + ROWS * (COLS + 1));
+
+    for (unsigned r = 0; r < ROWS; ++r) {
+        for (unsigned c = 0; c < COLS; ++c) {
+            out[at++] = board[r][c];
+        }
+        out[at++] = '\n';
+    }
+}
+
+#endif  // PUZZLE_IO_HPP_
@@ -0,0 +1,120 @@
+/// @file WordPool.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 9/13/2022
+/// @brief
+///     Length-bucketed word list for CrossSolver.cpp. Distinct words are
+/// stored back to back in one buffer, grouped by length, with their offsets,
+/// lengths and remaining copy counts in parallel arrays, so the words of a
+/// given length are one contiguous range.
+
+#ifndef WORD_POOL_HPP_
+#define WORD_POOL_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct word_pool_t {
+    std::string letters;                // every distinct word, back to back
+    std::vector<std::uint32_t> offset;  // start of word i in 'letters'
+    std::vector<std::uint8_t> length;   // length of word i
+    std::vector<unsigned> count;        // unused copies of word i
+    std::vector<std::uint32_t> first;   // words of length n: [first[n],
+                                        //   first[n+1])
+    std::size_t remaining = 0;          // unused copies of every word
+
+    // group the words by length (file order within a length), collapsing
+    // duplicates into counts
+    void build(const std::vector<std::string>& words) {
+        std::vector<std::string> order = words;  // words sorted by length
+
+        std::stable_sort(order.begin(), order.end(),
+            [](const std::string& lhs, const std::string& rhs) {
+                return lhs.length() < rhs.length();
+            });
+
+        letters.clear();
+        offset.clear();
+        length.clear();
+        count.clear();
+        remaining = words.size();
+
+        std::size_t longest = order.size() ? order.back().length() : 0;
+
+        first.assign(longest + 2, 0);
+
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const std::string& word = order[i];
+            std::size_t len = word.length();
+
+            // an earlier copy can only be in the bucket built so far
+            std::uint32_t id = first[len];
+
+            while (
+                id < offset.size() &&
+                letters.compare(offset[id], len, word) != 0
+            ) {
+                ++id;
+            }
+
+            if (id < offset.size()) {
+                ++count[id];
+                continue;
+            }
+
+            offset.push_back((std::uint32_t)letters.size());
+            length.push_back((std::uint8_t)len);
+            count.push_back(1);
+            letters += word;
+
+            // every later length starts after this word
+            for (std::size_t n = len + 1; n < first.size(); ++n) {
+                first[n] = (std::uint32_t)offset.size();
+            }
+        }
+    }
+
+    // index range of the words with 'len' letters
+    std::uint32_t begin(std::size_t len) const {
+        return len < first.size() ? first[len] : (std::uint32_t)offset.size();
+    }
+
+    std::uint32_t end(std::size_t len) const {
+        return len + 1 < first.size() ? first[len + 1]
+                                      : (std::uint32_t)offset.size();
+    }
+
+    // first letter of word i
+    const char* word(std::uint32_t i) const {
+        return letters.data() + offset[i];
+    }
+
+    // use up / give back one copy of word i
+    void take(std::uint32_t i) {
+        --count[i];
+        --remaining;
+    }
+
+    void give(std::uint32_t i) {
+        ++count[i];
+        ++remaining;
+    }
+
+    bool empty() const { return !remaining; }
+
+    // the unused copies, as a plain list
+    std::vector<std::string> list() const {
+        std::vector<std::string> words{};
+
+        for (std::uint32_t i = 0; i < offset.size(); ++i) {
+            for (unsigned n = 0; n < count[i]; ++n) {
+                words.emplace_back(word(i), length[i]);
+            }
+        }
+
+        return words;
+    }
+};
+
+#endif  // WORD_POOL_HPP_
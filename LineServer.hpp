@@ -0,0 +1,512 @@
+/// @file LineServer.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Line-oriented request servers shared by Wordle.cpp and
+/// CrossSolver.cpp: one session over a pair of descriptors (stdin daemons),
+/// or every connection to a Unix domain socket over a small thread pool.
+///
+/// @note A session answers one connection through two members:
+///     bool take(const std::string& line, std::string& reply)
+///         handle one request line; false closes the connection
+///     void finish(std::string& reply)
+///         the input ended without a close
+/// Replies are appended to 'reply' and sent once no further request is
+/// waiting. The socket server reads every connection with epoll on one
+/// thread and hands whole request lines to the workers; each connection is
+/// served by one worker at a time, in order. Its sockets never block: replies
+/// the client has not taken yet wait in memory and are written as it reads,
+/// so neither an idle client nor one which stops reading holds a worker.
+
+#ifndef LINE_SERVER_HPP_
+#define LINE_SERVER_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::size_t LINE_LIMIT = 1 << 16;    // longest request line accepted
+const std::size_t QUEUE_LIMIT = 256;       // lines read ahead of the worker
+const std::size_t OUTPUT_LIMIT = 1 << 20;  // unsent replies before reads stop
+const int EPOLL_EVENTS = 64;               // readiness events per wait
+
+/// @brief Write a whole buffer to a blocking descriptor, retrying partial
+/// writes. Shared with PuzzleIO.hpp's board output.
+///
+/// @param fd : The descriptor to write to.
+/// @param data : The bytes to write.
+///
+/// @return whether every byte was written.
+
+inline bool write_buffer(int fd, const std::string& data) {
+    std::size_t sent = 0;
+
+    while (sent < data.size()) {
+        ssize_t put = ::write(fd, data.data() + sent, data.size() - sent);
+
+        if (put < 0 && errno == EINTR) {
+            continue;
+        } else if (put <= 0) {
+            return false;
+        }
+
+        sent += (std::size_t)put;
+    }
+
+    return true;
+}
+
+struct channel_t {
+    int in_fd;              // descriptor requests are read from
+    int out_fd;             // descriptor responses are written to
+    char buf[4096];         // raw bytes read but not yet consumed
+    std::size_t head = 0;   // index of first unconsumed byte in buf
+    std::size_t tail = 0;   // index one past last valid byte in buf
+
+    // whether a read_line() could finish without blocking on more input
+    bool buffered() const {
+        return std::find(buf + head, buf + tail, '\n') != buf + tail;
+    }
+
+    // read one line (without the newline); false on end of input
+    bool read_line(std::string& line) {
+        line.clear();
+
+        while (true) {
+            while (head < tail) {
+                char ch = buf[head++];
+
+                if (ch == '\n') {
+                    return true;
+                } else if (ch != '\r') {
+                    line += ch;
+                }
+            }
+
+            ssize_t got = ::read(in_fd, buf, sizeof(buf));
+
+            if (got < 0 && errno == EINTR) {
+                continue;
+            } else if (got <= 0) {
+                return !line.empty();
+            }
+
+            head = 0;
+            tail = (std::size_t)got;
+        }
+    }
+
+    bool write_all(const std::string& data) {
+        return write_buffer(out_fd, data);
+    }
+};
+
+template <typename session_t>
+struct connection_t {
+    int fd;                          // the connection, closed with this
+    int poll_fd;                     // the epoll instance watching it
+    session_t session;               // its protocol state (worker only)
+    std::mutex lock;                 // guards every member below
+    std::deque<std::string> lines;   // whole request lines not yet taken
+    std::string partial;             // bytes after the last newline
+    std::string output;              // replies not yet written
+    std::size_t sent = 0;            // bytes of 'output' already written
+    bool queued = false;             // queued for or held by a worker
+    bool ended = false;              // no more lines will come
+    bool closed = false;             // no more replies will be made
+
+    connection_t(int conn_fd, int epoll_fd, session_t state)
+        : fd(conn_fd), poll_fd(epoll_fd), session(std::move(state)) {}
+
+    connection_t(const connection_t&) = delete;
+    connection_t& operator=(const connection_t&) = delete;
+
+    ~connection_t() { ::close(fd); }
+
+    // lines to answer, and room for the replies
+    bool ready() const {
+        return !closed && (!lines.empty() || ended) &&
+               output.size() - sent < OUTPUT_LIMIT;
+    }
+
+    // nothing left to read, answer or write
+    bool done() const {
+        return (ended || closed) && !queued && sent == output.size();
+    }
+
+    // write what the socket takes now; a failed write drops the rest and
+    // ends the connection
+    void flush() {
+        while (sent < output.size()) {
+            ssize_t put = ::send(fd, output.data() + sent,
+                                 output.size() - sent, MSG_NOSIGNAL);
+
+            if (put < 0 && errno == EINTR) {
+                continue;
+            } else if (put < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                output.erase(0, sent);
+                sent = 0;
+                return;
+            } else if (put <= 0) {
+                ended = closed = true;
+                break;
+            }
+
+            sent += (std::size_t)put;
+        }
+
+        output.clear();
+        sent = 0;
+    }
+
+    // re-arm the one-shot poll for what the connection waits on
+    void watch() {
+        epoll_event event{};
+
+        if (done()) {
+            // the poll loop sees the hang-up and forgets the connection
+            ::shutdown(fd, SHUT_RDWR);
+        } else {
+            if (
+                !ended && lines.size() < QUEUE_LIMIT &&
+                output.size() - sent < OUTPUT_LIMIT
+            ) {
+                event.events |= EPOLLIN;
+            }
+
+            if (sent < output.size()) {
+                event.events |= EPOLLOUT;
+            }
+
+            // only a worker holds it, and arms it when done
+            if (!event.events) {
+                return;
+            }
+        }
+
+        event.events |= EPOLLONESHOT;
+        event.data.fd = fd;
+        ::epoll_ctl(poll_fd, EPOLL_CTL_MOD, fd, &event);
+    }
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Serve one session over a pair of descriptors until it closes or the
+/// input ends.
+///
+/// @param session : The session.
+/// @param in_fd : The descriptor requests are read from.
+/// @param out_fd : The descriptor replies are written to.
+///
+/// @return whether every reply was written.
+
+template <typename session_t>
+bool serve_stream(session_t& session, int in_fd, int out_fd) {
+    channel_t chan{in_fd, out_fd, {}};
+    std::string line;   // current request line
+    std::string reply;  // replies not yet sent
+
+    while (chan.read_line(line)) {
+        if (!session.take(line, reply)) {
+            return chan.write_all(reply);
+        }
+
+        if (!chan.buffered()) {
+            if (!chan.write_all(reply)) {
+                return false;
+            }
+
+            reply.clear();
+        }
+    }
+
+    session.finish(reply);
+    return chan.write_all(reply);
+}
+
+/// @brief Take a connection's waiting lines and answer them. The caller has
+/// marked the connection queued.
+///
+/// @param conn : The connection.
+///
+/// @return whether to queue it again: more lines arrived meanwhile, and its
+/// unsent replies leave room for theirs.
+
+template <typename session_t>
+bool serve_lines(connection_t<session_t>& conn) {
+    std::deque<std::string> lines;
+    std::string reply;  // replies to 'lines', queued at once
+    bool ended, closed;
+
+    {
+        std::lock_guard<std::mutex> guard(conn.lock);
+        lines.swap(conn.lines);
+        ended = conn.ended;
+        closed = conn.closed;
+    }
+
+    for (const std::string& line : lines) {
+        if (!closed && !conn.session.take(line, reply)) {
+            closed = true;
+        }
+    }
+
+    // 'ended' is set with the last lines, so none were missed
+    if (ended && !closed) {
+        conn.session.finish(reply);
+        closed = true;
+    }
+
+    std::lock_guard<std::mutex> guard(conn.lock);
+
+    conn.closed = conn.closed || closed;
+    conn.output += reply;
+    conn.flush();
+    conn.queued = conn.ready();
+
+    // reading resumes now the lines are taken
+    conn.watch();
+
+    return conn.queued;
+}
+
+/// @brief Listen on a Unix domain socket and serve every connection with its
+/// own session: one thread polls the socket and every connection, and a
+/// fixed pool of workers answers the request lines read.
+///
+/// @param path : The socket path (replaced if it exists).
+/// @param make : Returns the session of a new connection.
+///
+/// @return the exit status.
+
+template <typename make_t>
+int serve_socket(const char* path, make_t make) {
+    using session_t = decltype(make());
+    using conn_ptr = std::shared_ptr<connection_t<session_t>>;
+
+    sockaddr_un addr{};  // address of the listening socket
+
+    if (std::strlen(path) >= sizeof(addr.sun_path)) {
+        std::cerr << "Socket path is too long." << std::endl;
+        return 1;
+    }
+
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+
+    if (listen_fd < 0) {
+        std::cerr << "socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path);
+    ::unlink(path);
+
+    if (
+        ::bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0 ||
+        ::listen(listen_fd, SOMAXCONN) < 0
+    ) {
+        std::cerr << "bind/listen: " << std::strerror(errno) << std::endl;
+        ::close(listen_fd);
+        return 1;
+    }
+
+    int poll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+
+    if (poll_fd < 0 || ::epoll_ctl(poll_fd, EPOLL_CTL_ADD, listen_fd,
+                                   &event) < 0) {
+        std::cerr << "epoll: " << std::strerror(errno) << std::endl;
+        ::close(listen_fd);
+        return 1;
+    }
+
+    std::unordered_map<int, conn_ptr> conns;  // open connections, by fd
+    std::deque<conn_ptr> ready;   // connections with lines to answer
+    std::mutex ready_lock;        // guards ready, stopping
+    std::condition_variable wake;  // a connection is ready, or a stop
+    bool stopping = false;        // set to end the workers
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+
+    for (unsigned i = 0; i < workers; ++i) {
+        pool.emplace_back([&]() {
+            while (true) {
+                conn_ptr conn;
+
+                {
+                    std::unique_lock<std::mutex> guard(ready_lock);
+
+                    wake.wait(guard, [&] {
+                        return stopping || !ready.empty();
+                    });
+
+                    if (ready.empty()) {
+                        return;
+                    }
+
+                    conn = std::move(ready.front());
+                    ready.pop_front();
+                }
+
+                // behind the other ready connections, so a client sending
+                // without pause never holds a worker
+                if (serve_lines(*conn)) {
+                    std::lock_guard<std::mutex> guard(ready_lock);
+                    ready.push_back(std::move(conn));
+                }
+            }
+        });
+    }
+
+    epoll_event events[EPOLL_EVENTS];
+
+    while (true) {
+        int count = ::epoll_wait(poll_fd, events, EPOLL_EVENTS, -1);
+
+        if (count < 0 && errno == EINTR) {
+            continue;
+        } else if (count < 0) {
+            std::cerr << "epoll: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int e = 0; e < count; ++e) {
+            int fd = events[e].data.fd;
+
+            if (fd == listen_fd) {
+                int conn_fd = ::accept4(listen_fd, nullptr, nullptr,
+                                        SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+                if (conn_fd < 0) {
+                    continue;
+                }
+
+                event.events = EPOLLIN | EPOLLONESHOT;
+                event.data.fd = conn_fd;
+
+                if (::epoll_ctl(poll_fd, EPOLL_CTL_ADD, conn_fd, &event) < 0) {
+                    ::close(conn_fd);
+                    continue;
+                }
+
+                conns[conn_fd] = std::make_shared<connection_t<session_t>>(
+                    conn_fd, poll_fd, make());
+                continue;
+            }
+
+            auto found = conns.find(fd);
+
+            if (found == conns.end()) {
+                continue;
+            }
+
+            conn_ptr conn = found->second;
+            char buf[4096];      // one read per readiness, fair to all
+            bool queue = false;  // whether this hands the lines to a worker
+            bool done;           // whether the connection is finished
+
+            {
+                std::lock_guard<std::mutex> guard(conn->lock);
+
+                conn->flush();
+
+                ssize_t got = 0;                // bytes read, if any
+                bool waiting = conn->ended;     // whether nothing was read
+
+                if (!conn->ended) {
+                    got = ::read(fd, buf, sizeof(buf));
+                    waiting = got < 0 && (errno == EAGAIN ||
+                                          errno == EWOULDBLOCK ||
+                                          errno == EINTR);
+                }
+
+                for (ssize_t i = 0; i < got; ++i) {
+                    if (buf[i] == '\n') {
+                        conn->lines.push_back(std::move(conn->partial));
+                        conn->partial.clear();
+                    } else if (buf[i] != '\r') {
+                        conn->partial += buf[i];
+                    }
+                }
+
+                // a hang-up, an error or a runaway line ends the input
+                if (
+                    !waiting &&
+                    (got <= 0 || conn->partial.size() > LINE_LIMIT)
+                ) {
+                    if (got <= 0 && conn->partial.size()) {
+                        conn->lines.push_back(std::move(conn->partial));
+                    }
+
+                    conn->ended = true;
+                }
+
+                if (!conn->queued && conn->ready()) {
+                    conn->queued = queue = true;
+                }
+
+                done = conn->done();
+
+                if (!done) {
+                    conn->watch();
+                }
+            }
+
+            // the connection is closed once no worker holds it either
+            if (done) {
+                ::epoll_ctl(poll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                conns.erase(found);
+            }
+
+            if (queue) {
+                {
+                    std::lock_guard<std::mutex> guard(ready_lock);
+                    ready.push_back(std::move(conn));
+                }
+
+                wake.notify_one();
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(ready_lock);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    ::close(poll_fd);
+    ::close(listen_fd);
+    ::unlink(path);
+
+    return 0;
+}
+
+#endif  // LINE_SERVER_HPP_
@@ -0,0 +1,69 @@
+/// @file Absurdle.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Adversary for the Absurdle mode of Wordle.cpp: no answer is fixed,
+/// and each guess gets whichever feedback leaves the most candidates.
+
+#ifndef ABSURDLE_HPP_
+#define ABSURDLE_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "Feedback.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Answer a guess adversarially: split the candidates by the feedback
+/// they would give, keep the largest group and return its feedback.
+///
+/// @param guess : The packed guess.
+/// @param candidates : The packed words consistent with every earlier
+/// feedback, narrowed in place.
+/// @param scratch : Buffer for the feedback of each candidate.
+///
+/// @note The candidates are scored in one bulk pass and counted in a fixed
+/// histogram of every feedback pattern. Ties go to the lowest pattern, the
+/// one revealing the fewest greens and yellows.
+///
+/// @return the feedback given to the guess.
+
+template <int N>
+typename word_spec_t<N>::pattern_t absurdle_feedback(
+    typename word_spec_t<N>::word_t guess,
+    std::vector<typename word_spec_t<N>::word_t>& candidates,
+    std::vector<typename word_spec_t<N>::pattern_t>& scratch) {
+    using pattern_t = typename word_spec_t<N>::pattern_t;
+
+    std::uint32_t buckets[word_spec_t<N>::patterns] {};  // candidates each
+    pattern_t best = 0;                                   // largest bucket
+    std::size_t kept = 0;                                 // candidates kept
+
+    scratch.resize(candidates.size());
+    score_many<N>(guess, candidates.data(), candidates.size(),
+                  scratch.data());
+
+    for (pattern_t pattern : scratch) {
+        buckets[pattern]++;
+    }
+
+    for (int pattern = 1; pattern < word_spec_t<N>::patterns; ++pattern) {
+        if (buckets[pattern] > buckets[best]) {
+            best = (pattern_t)pattern;
+        }
+    }
+
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        if (scratch[i] == best) {
+            candidates[kept++] = candidates[i];
+        }
+    }
+
+    candidates.resize(kept);
+
+    return best;
+}
+
+#endif  // ABSURDLE_HPP_
@@ -0,0 +1,300 @@
+/// @file Bench.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Headless self-play benchmark for Wordle.cpp: the solver plays every
+/// word of the list as the answer, in parallel, and the guess counts are
+/// tallied.
+///
+/// @note A guess depends only on the feedback received so far, so the opening
+/// and the second guess after each opening feedback are chosen once up front,
+/// and the third guess after each pair of feedbacks is cached as games reach
+/// it.
+
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CandidateSet.hpp"
+#include "FeedbackMatrix.hpp"
+#include "Frequency.hpp"
+#include "Sampling.hpp"
+#include "Solver.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+// games still unsolved after this many guesses are abandoned
+const int BENCH_TURN_CAP = 20;
+
+// marks a third guess not chosen yet
+const std::uint32_t NO_GUESS = 0xffffffff;
+
+enum strategy_t {
+    EXPECTED,  // fewest expected candidates left
+    ENTROPY,   // most expected information
+    HARD,      // fewest expected candidates left, guessing only candidates
+    FREQUENCY, // letters splitting the candidates most evenly
+    SAMPLED    // fewest expected candidates left, estimated by sampling
+};
+
+struct bench_result_t {
+    std::vector<std::uint64_t> turns;  // [n]: games won in n guesses, [0]:
+                                       // games abandoned
+    std::uint64_t games = 0;           // games played
+    double seconds = 0;                // wall time of the games
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Read a strategy name.
+///
+/// @param text : "expected", "entropy", "hard", "frequency" or "sampled".
+/// @param strategy : Receives the strategy.
+///
+/// @return whether the name was valid.
+
+inline bool parse_strategy(const std::string& text, strategy_t& strategy) {
+    if (text == "expected") {
+        strategy = EXPECTED;
+    } else if (text == "entropy") {
+        strategy = ENTROPY;
+    } else if (text == "hard") {
+        strategy = HARD;
+    } else if (text == "frequency") {
+        strategy = FREQUENCY;
+    } else if (text == "sampled") {
+        strategy = SAMPLED;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Choose the next guess of a strategy.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param candidates : The indices of the words which could be the answer.
+/// @param strategy : The strategy choosing the guess.
+///
+/// @return the index of the guess.
+
+inline std::uint32_t choose_guess(const feedback_matrix_t& matrix,
+                                  const std::vector<std::uint32_t>& candidates,
+                                  strategy_t strategy) {
+    if (candidates.size() <= 2) {
+        return candidates[0];
+    }
+
+    // entropy orders by information first, the others by ranks_before()
+    auto better = [strategy](const rank_t& lhs, const rank_t& rhs) {
+        if (strategy == ENTROPY && lhs.entropy != rhs.entropy) {
+            return lhs.entropy > rhs.entropy;
+        }
+
+        return ranks_before(lhs, rhs);
+    };
+
+    std::size_t pool = strategy == HARD ? candidates.size() : matrix.words;
+    rank_t best{};
+
+    for (std::size_t i = 0; i < pool; ++i) {
+        std::uint32_t guess = strategy == HARD ? candidates[i]
+                                               : (std::uint32_t)i;
+        rank_t rank = rate_row(matrix, guess, candidates);
+
+        if (i == 0 || better(rank, best)) {
+            best = rank;
+        }
+    }
+
+    return best.guess;
+}
+
+/// @brief Choose the next guess of a strategy from a candidate set.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param words : The packed word list.
+/// @param candidates : The words which could be the answer.
+/// @param table : The letter counts of the candidates (frequency only).
+/// @param strategy : The strategy choosing the guess.
+///
+/// @return the index of the guess.
+
+inline std::uint32_t next_guess(const feedback_matrix_t& matrix,
+                                const std::vector<word_t>& words,
+                                const candidate_set_t& candidates,
+                                const letter_table_t<>& table,
+                                strategy_t strategy) {
+    if (strategy == FREQUENCY && table.count > 2) {
+        return frequency_guess(words, table, candidates);
+    }
+
+    if (strategy != SAMPLED || candidates.count() <= 2) {
+        return choose_guess(matrix, candidates.indices(), strategy);
+    }
+
+    // games run in parallel already; the seed depends only on the
+    // candidates, so every game reaching them chooses alike
+    std::vector<word_t> answers;
+
+    for (std::uint32_t index : candidates.indices()) {
+        answers.push_back(words[index]);
+    }
+
+    return sample_guesses<WORD_LEN>(words, answers, 1, hash_words(answers), 1,
+                                    [] { return false; })[0].guess;
+}
+
+/// @brief Play one game to the end.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param words : The packed word list.
+/// @param all : The letter counts of every word (frequency only).
+/// @param answer : The index of the answer.
+/// @param strategy : The strategy choosing the guesses.
+/// @param opening : The first guess.
+/// @param second : The second guess after each feedback to the first.
+/// @param third : The third guess after each pair of feedbacks, filled in as
+/// games reach it (shared by every thread).
+///
+/// @return the number of guesses taken, or 0 if the game was abandoned.
+
+inline int play_game(const feedback_matrix_t& matrix,
+                     const std::vector<word_t>& words,
+                     const letter_table_t<>& all, std::uint32_t answer,
+                     strategy_t strategy, std::uint32_t opening,
+                     const std::uint32_t second[NUM_PATTERNS],
+                     std::vector<std::atomic<std::uint32_t>>& third) {
+    candidate_set_t candidates;  // words which could still be the answer
+    candidate_set_t before;      // the candidates before the last feedback
+    letter_table_t<> table = all;  // letter counts of the candidates
+    pattern_t pattern{};         // feedback of the last guess
+    std::size_t history = 0;     // feedbacks of the first two guesses
+
+    candidates.fill(matrix.words);
+
+    for (int turn = 1; turn <= BENCH_TURN_CAP; ++turn) {
+        std::uint32_t guess;
+
+        if (turn == 1) {
+            guess = opening;
+        } else if (turn == 2) {
+            guess = second[pattern];
+        } else if (turn == 3 && third[history] != NO_GUESS) {
+            guess = third[history];
+        } else {
+            guess = next_guess(matrix, words, candidates, table, strategy);
+
+            // two threads may both choose it; they store the same guess
+            if (turn == 3) {
+                third[history] = guess;
+            }
+        }
+
+        pattern = matrix.at(guess, answer);
+        history = history * NUM_PATTERNS + pattern;
+
+        if (pattern == ALL_GREEN) {
+            return turn;
+        }
+
+        if (strategy == FREQUENCY) {
+            before = candidates;
+            apply_feedback(matrix, candidates, guess, pattern);
+            forget_eliminated(table, words, before, candidates);
+        } else {
+            apply_feedback(matrix, candidates, guess, pattern);
+        }
+    }
+
+    return 0;
+}
+
+/// @brief Play every word of the list as the answer, splitting the games
+/// across all hardware threads.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param words : The packed word list.
+/// @param strategy : The strategy choosing the guesses.
+///
+/// @return the tally of the games.
+
+inline bench_result_t run_bench(const feedback_matrix_t& matrix,
+                                const std::vector<word_t>& words,
+                                strategy_t strategy) {
+    using clock = std::chrono::steady_clock;
+
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    std::atomic<std::uint32_t> next{0};  // next answer to play
+    std::vector<std::vector<std::uint64_t>> tallies(
+        workers, std::vector<std::uint64_t>(BENCH_TURN_CAP + 1));
+    std::uint32_t second[NUM_PATTERNS] {};
+    std::vector<std::atomic<std::uint32_t>> third(NUM_PATTERNS *
+                                                  NUM_PATTERNS);
+    bench_result_t result;
+    candidate_set_t all;     // every word
+    letter_table_t<> counts;  // letter counts of every word
+
+    auto start = clock::now();
+
+    all.fill(matrix.words);
+    fill_table(counts, words, all);
+
+    for (auto& guess : third) {
+        guess = NO_GUESS;
+    }
+
+    std::uint32_t opening = next_guess(matrix, words, all, counts, strategy);
+
+    for (int pattern = 0; pattern < NUM_PATTERNS; ++pattern) {
+        candidate_set_t after = all;  // candidates left by this feedback
+        letter_table_t<> table = counts;
+
+        apply_feedback(matrix, after, opening, (pattern_t)pattern);
+        forget_eliminated(table, words, all, after);
+
+        if (after.count()) {
+            second[pattern] = next_guess(matrix, words, after, table,
+                                         strategy);
+        }
+    }
+
+    for (unsigned t = 0; t < workers; ++t) {
+        pool.emplace_back([&, t]() {
+            for (std::uint32_t answer = next++; answer < matrix.words;
+                 answer = next++) {
+                tallies[t][play_game(matrix, words, counts, answer, strategy,
+                                     opening, second, third)]++;
+            }
+        });
+    }
+
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    result.turns.assign(BENCH_TURN_CAP + 1, 0);
+
+    for (auto& tally : tallies) {
+        for (int n = 0; n <= BENCH_TURN_CAP; ++n) {
+            result.turns[n] += tally[n];
+        }
+    }
+
+    result.games = matrix.words;
+    result.seconds = std::chrono::duration<double>(clock::now() - start)
+                         .count();
+
+    return result;
+}
+
+#endif  // BENCH_HPP_
@@ -0,0 +1,113 @@
+/// @file CandidateSet.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Dense bitset of the words which could still be the answer, for
+/// Wordle.cpp. Applying feedback ANDs the set with the partition of answers
+/// giving that feedback, 64 words per step, and the remaining count is a
+/// popcount.
+
+#ifndef CANDIDATE_SET_HPP_
+#define CANDIDATE_SET_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "FeedbackMatrix.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type Definitions
+
+struct candidate_set_t {
+    std::vector<std::uint64_t> bits;  // bit i of block i / 64: word i
+    std::size_t words = 0;            // number of words in the list
+
+    // every word of a list of 'count' words
+    void fill(std::size_t count) {
+        words = count;
+        bits.assign((count + 63) / 64, ~0ULL);
+
+        if (count % 64) {
+            bits.back() = (1ULL << (count % 64)) - 1;
+        }
+    }
+
+    bool test(std::size_t word) const {
+        return (bits[word / 64] >> (word % 64)) & 1;
+    }
+
+    // number of words in the set
+    std::size_t count() const {
+        std::size_t total = 0;
+
+        for (std::uint64_t block : bits) {
+            total += (std::size_t)__builtin_popcountll(block);
+        }
+
+        return total;
+    }
+
+    // indices of the words in the set, ascending
+    std::vector<std::uint32_t> indices() const {
+        std::vector<std::uint32_t> list;
+
+        list.reserve(count());
+
+        for (std::size_t b = 0; b < bits.size(); ++b) {
+            for (std::uint64_t block = bits[b]; block; block &= block - 1) {
+                list.push_back((std::uint32_t)(b * 64 +
+                               (std::size_t)__builtin_ctzll(block)));
+            }
+        }
+
+        return list;
+    }
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Mask of the answers in one 64-word block giving a feedback.
+///
+/// @param row : The feedback matrix row of the guess.
+/// @param block : The index of the block.
+/// @param words : The number of words in the list.
+/// @param pattern : The feedback to match.
+///
+/// @return bit k set when answer block * 64 + k gives 'pattern'.
+
+inline std::uint64_t partition_block(const pattern_t* row, std::size_t block,
+                                     std::size_t words, pattern_t pattern) {
+    std::size_t first = block * 64;
+    std::size_t span = words - first < 64 ? words - first : 64;
+    std::uint64_t mask = 0;
+
+    for (std::size_t k = 0; k < span; ++k) {
+        mask |= (std::uint64_t)(row[first + k] == pattern) << k;
+    }
+
+    return mask;
+}
+
+/// @brief Narrow a candidate set to the answers consistent with a feedback,
+/// building the partition on the fly only for blocks still holding
+/// candidates.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param set : The candidates, narrowed in place.
+/// @param guess : The index of the guess which was played.
+/// @param pattern : The feedback the guess received.
+
+inline void apply_feedback(const feedback_matrix_t& matrix,
+                           candidate_set_t& set, std::uint32_t guess,
+                           pattern_t pattern) {
+    const pattern_t* row = matrix.row(guess);
+
+    for (std::size_t b = 0; b < set.bits.size(); ++b) {
+        if (set.bits[b]) {
+            set.bits[b] &= partition_block(row, b, matrix.words, pattern);
+        }
+    }
+}
+
+#endif  // CANDIDATE_SET_HPP_
@@ -0,0 +1,621 @@
+/// @file DecisionTree.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Precomputed decision tree for Wordle.cpp: the guess to play for
+/// every sequence of feedback, chosen offline to minimize the total number of
+/// guesses over every answer, then walked by feedback with one lookup a move.
+///
+/// @note File layout: a tree_header_t, then 'nodes' tree_node_t, root first,
+/// then 'rows' rows of NUM_PATTERNS uint32_t child indices, one row per node
+/// with more than one answer left. The header records the word count and a
+/// hash of the packed word list, like the feedback matrix.
+///
+/// @note The builder searches the 'beam' best guesses of each node by
+/// expected candidates left, abandoning a guess as soon as a lower bound on
+/// its cost reaches the best found. Each subtree under an opening guess is
+/// built on its own thread and appended to a checkpoint file when done, so an
+/// interrupted build resumes where it stopped.
+
+#ifndef DECISION_TREE_HPP_
+#define DECISION_TREE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "FeedbackMatrix.hpp"
+#include "Solver.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::uint32_t TREE_VERSION = 1;        // bumped when the layout changes
+const std::uint32_t NO_NODE = 0xffffffff;    // missing child, or no children
+const std::uint64_t NO_COST = ~0ULL;         // subtree not worth building
+const int TREE_DEPTH_CAP = 8;                // most guesses along any branch
+
+struct tree_node_t {
+    std::uint32_t guess;  // index of the guess in the word list
+    std::uint32_t row;    // row of child indices, NO_NODE if this guess is
+                          // the only answer left
+};
+
+struct tree_t {
+    std::vector<tree_node_t> nodes;     // every node, root first
+    std::vector<std::uint32_t> edges;   // NUM_PATTERNS children per row
+    std::uint64_t cost = 0;             // guesses over every answer
+
+    // node reached from node 'node' by feedback 'pattern', or NO_NODE
+    std::uint32_t child(std::uint32_t node, pattern_t pattern) const {
+        return nodes[node].row == NO_NODE
+                   ? NO_NODE
+                   : edges[(std::size_t)nodes[node].row * NUM_PATTERNS +
+                           pattern];
+    }
+};
+
+struct tree_header_t {
+    char magic[4];          // "WTRE" for a tree, "WTCK" for a checkpoint
+    std::uint32_t version;  // TREE_VERSION
+    std::uint32_t words;    // number of words in the list
+    std::uint32_t beam;     // guesses searched at each node
+    std::uint64_t hash;     // hash_words() of the word list
+    std::uint64_t cost;     // guesses over every answer (tree only)
+    std::uint32_t nodes;    // number of nodes (tree only)
+    std::uint32_t rows;     // number of child rows (tree only)
+};
+
+struct subtree_header_t {
+    std::uint32_t opening;  // index of the opening guess
+    std::uint32_t pattern;  // feedback to it leading to the subtree
+    std::uint64_t cost;     // guesses over the subtree's answers
+    std::uint32_t nodes;    // number of nodes
+    std::uint32_t rows;     // number of child rows
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Append a tree to another, shifting its indices past the nodes and
+/// rows already there.
+///
+/// @param into : The tree appended to.
+/// @param sub : The tree to append.
+///
+/// @return the index of the appended root in 'into'.
+
+inline std::uint32_t graft(tree_t& into, const tree_t& sub) {
+    std::uint32_t base = (std::uint32_t)into.nodes.size();
+    std::uint32_t row_base = (std::uint32_t)(into.edges.size() /
+                                             NUM_PATTERNS);
+
+    for (tree_node_t node : sub.nodes) {
+        into.nodes.push_back({node.guess, node.row == NO_NODE
+                                              ? NO_NODE
+                                              : node.row + row_base});
+    }
+
+    for (std::uint32_t child : sub.edges) {
+        into.edges.push_back(child == NO_NODE ? NO_NODE : child + base);
+    }
+
+    into.cost += sub.cost;
+    return base;
+}
+
+/// @brief Check the indices of a tree read from a file: every guess names a
+/// word of the list, every row a row of the tree and every child a node.
+///
+/// @param tree : The tree.
+/// @param words : The number of words in the list.
+///
+/// @return whether walking the tree stays in range.
+
+inline bool valid_tree(const tree_t& tree, std::uint32_t words) {
+    std::size_t rows = tree.edges.size() / NUM_PATTERNS;
+
+    for (tree_node_t node : tree.nodes) {
+        if (node.guess >= words || (node.row != NO_NODE && node.row >= rows)) {
+            return false;
+        }
+    }
+
+    for (std::uint32_t child : tree.edges) {
+        if (child != NO_NODE && child >= tree.nodes.size()) {
+            return false;
+        }
+    }
+
+    return !tree.nodes.empty();
+}
+
+/// @brief Whether node and row counts read from a file fit a tree of a word
+/// list: each level's nodes hold disjoint answers, so no tree has more than
+/// TREE_DEPTH_CAP nodes per word. Checked before the counts size anything.
+///
+/// @param nodes : The number of nodes.
+/// @param rows : The number of child rows.
+/// @param words : The number of words in the list.
+///
+/// @return whether the counts are possible.
+
+inline bool tree_fits(std::uint32_t nodes, std::uint32_t rows,
+                      std::uint32_t words) {
+    return nodes <= (std::uint64_t)words * TREE_DEPTH_CAP && rows <= nodes;
+}
+
+/// @brief Lower bound on the guesses needed to solve a group of answers: one
+/// each, and a second for all but the one a first guess could hit.
+///
+/// @param size : The number of answers.
+///
+/// @return the bound.
+
+inline std::uint64_t cost_bound(std::size_t size) {
+    return size <= 1 ? size : 2 * size - 1;
+}
+
+/// @brief Choose the guesses worth searching at a node.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param candidates : The indices of the answers left.
+/// @param beam : The number of guesses to choose.
+///
+/// @return up to 'beam' guess indices, best first by ranks_before().
+
+inline std::vector<std::uint32_t> beam_guesses(
+    const feedback_matrix_t& matrix,
+    const std::vector<std::uint32_t>& candidates, std::size_t beam) {
+    std::vector<rank_t> ranks(matrix.words);
+    std::vector<std::uint32_t> guesses;
+
+    for (std::size_t g = 0; g < matrix.words; ++g) {
+        ranks[g] = rate_row(matrix, (std::uint32_t)g, candidates);
+    }
+
+    beam = std::min(beam, ranks.size());
+    std::partial_sort(ranks.begin(), ranks.begin() + (long)beam, ranks.end(),
+                      ranks_before);
+
+    for (std::size_t i = 0; i < beam; ++i) {
+        guesses.push_back(ranks[i].guess);
+    }
+
+    return guesses;
+}
+
+/// @brief Build the cheapest subtree solving a group of answers, searching
+/// the 'beam' best guesses at every node.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param candidates : The indices of the answers left.
+/// @param beam : The number of guesses searched at each node.
+/// @param depth : The number of guesses already made.
+/// @param bound : The cost to beat; guesses which cannot are abandoned.
+/// @param out : Receives the subtree, if one beat the bound.
+///
+/// @return the total guesses over every answer, or NO_COST if no subtree
+/// beat the bound.
+
+inline std::uint64_t build_subtree(const feedback_matrix_t& matrix,
+                                   const std::vector<std::uint32_t>& candidates,
+                                   std::size_t beam, int depth,
+                                   std::uint64_t bound, tree_t& out) {
+    std::size_t size = candidates.size();
+
+    if (depth >= TREE_DEPTH_CAP || cost_bound(size) >= bound) {
+        return NO_COST;
+    } else if (size == 1 || (size == 2 && depth + 1 < TREE_DEPTH_CAP)) {
+        // guess one answer; the other (if any) is known from the feedback
+        out = tree_t{};
+        out.nodes.push_back({candidates[0], NO_NODE});
+        out.cost = 1;
+
+        if (size == 2) {
+            out.nodes[0].row = 0;
+            out.nodes.push_back({candidates[1], NO_NODE});
+            out.edges.assign(NUM_PATTERNS, NO_NODE);
+            out.edges[matrix.at(candidates[0], candidates[1])] = 1;
+            out.cost = 3;
+        }
+
+        return out.cost;
+    }
+
+    std::uint64_t best = bound;  // cost of the best subtree so far
+    std::vector<std::uint32_t> sorted(size);  // candidates by feedback
+
+    for (std::uint32_t guess : beam_guesses(matrix, candidates, beam)) {
+        const pattern_t* row = matrix.row(guess);
+        std::uint32_t counts[NUM_PATTERNS] {};   // candidates per feedback
+        std::uint32_t starts[NUM_PATTERNS + 1];  // offsets into 'sorted'
+        std::uint64_t floor = size;              // lower bound of the guess
+
+        for (std::uint32_t answer : candidates) {
+            counts[row[answer]]++;
+        }
+
+        // a guess leaving every candidate together teaches nothing
+        if (counts[ALL_GREEN] == 0 && std::count(counts, counts +
+                                                 NUM_PATTERNS, size)) {
+            continue;
+        }
+
+        starts[0] = 0;
+
+        for (int p = 0; p < NUM_PATTERNS; ++p) {
+            floor += p == ALL_GREEN ? 0 : cost_bound(counts[p]);
+            starts[p + 1] = starts[p] + counts[p];
+        }
+
+        if (floor >= best) {
+            continue;
+        }
+
+        for (std::uint32_t answer : candidates) {
+            sorted[starts[row[answer]]++] = answer;
+        }
+
+        // 'starts' now holds each group's end
+        tree_t trial;
+        std::uint64_t cost = floor;  // bound, made exact group by group
+
+        trial.nodes.push_back({guess, 0});
+        trial.edges.assign(NUM_PATTERNS, NO_NODE);
+        trial.cost = size;
+
+        for (int p = 0; p < NUM_PATTERNS && cost < best; ++p) {
+            if (p == ALL_GREEN || !counts[p]) {
+                continue;
+            }
+
+            std::vector<std::uint32_t> group(
+                sorted.begin() + (starts[p] - counts[p]),
+                sorted.begin() + starts[p]);
+            std::uint64_t others = cost - cost_bound(counts[p]);
+            tree_t sub;
+
+            std::uint64_t spent = build_subtree(matrix, group, beam,
+                                                depth + 1, best - others,
+                                                sub);
+
+            if (spent == NO_COST) {
+                cost = NO_COST;
+                break;
+            }
+
+            cost = others + spent;
+            trial.edges[p] = graft(trial, sub);
+        }
+
+        if (cost < best) {
+            best = cost;
+            out = std::move(trial);
+
+            // nothing can beat the lower bound of the whole group
+            if (best == cost_bound(size)) {
+                break;
+            }
+        }
+    }
+
+    return best < bound ? best : NO_COST;
+}
+
+/// @brief Read the subtrees finished by an earlier build from a checkpoint
+/// file, or start the file over if it belongs to another build.
+///
+/// @param path : The checkpoint file.
+/// @param header : The header of this build.
+/// @param done : Receives each finished subtree by (opening, pattern).
+///
+/// @return the file, open for appending, or nullptr if it cannot be written.
+
+inline std::FILE* open_checkpoint(
+    const std::string& path, const tree_header_t& header,
+    std::map<std::pair<std::uint32_t, std::uint32_t>, tree_t>& done) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    tree_header_t found{};
+    subtree_header_t entry{};
+    long whole = 0;  // end of the last complete subtree
+
+    if (
+        file && std::fread(&found, sizeof(found), 1, file) == 1 &&
+        std::memcmp(&found, &header, sizeof(header)) == 0
+    ) {
+        whole = (long)sizeof(header);
+
+        // a subtree out of range ends the file like a torn one
+        while (
+            std::fread(&entry, sizeof(entry), 1, file) == 1 &&
+            entry.opening < header.words && entry.pattern < NUM_PATTERNS &&
+            tree_fits(entry.nodes, entry.rows, header.words)
+        ) {
+            tree_t sub;
+
+            sub.nodes.resize(entry.nodes);
+            sub.edges.resize((std::size_t)entry.rows * NUM_PATTERNS);
+            sub.cost = entry.cost;
+
+            if (
+                std::fread(sub.nodes.data(), sizeof(tree_node_t),
+                           sub.nodes.size(), file) != sub.nodes.size() ||
+                std::fread(sub.edges.data(), sizeof(std::uint32_t),
+                           sub.edges.size(), file) != sub.edges.size() ||
+                !valid_tree(sub, header.words)
+            ) {
+                break;
+            }
+
+            done[{entry.opening, entry.pattern}] = std::move(sub);
+            whole = std::ftell(file);
+        }
+    }
+
+    if (file) {
+        std::fclose(file);
+    }
+
+    // keep the complete subtrees, dropping a torn tail or another build
+    if (!whole) {
+        file = std::fopen(path.c_str(), "wb");
+
+        if (file && std::fwrite(&header, sizeof(header), 1, file) != 1) {
+            std::fclose(file);
+            file = nullptr;
+        }
+    } else if (::truncate(path.c_str(), whole) != 0) {
+        file = nullptr;
+    } else {
+        file = std::fopen(path.c_str(), "ab");
+    }
+
+    return file;
+}
+
+/// @brief Build the decision tree of a word list: every opening guess in the
+/// beam, with every subtree below it, keeping the cheapest opening.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param hash : hash_words() of the word list.
+/// @param beam : The number of guesses searched at each node.
+/// @param checkpoint : The file finished subtrees are saved to.
+/// @param tree : Receives the tree.
+///
+/// @note Progress is reported on std::cerr.
+///
+/// @return whether every answer could be solved within TREE_DEPTH_CAP
+/// guesses.
+
+inline bool build_tree(const feedback_matrix_t& matrix, std::uint64_t hash,
+                       std::uint32_t beam, const std::string& checkpoint,
+                       tree_t& tree) {
+    using clock = std::chrono::steady_clock;
+
+    tree_header_t header{{'W', 'T', 'C', 'K'}, TREE_VERSION,
+                         (std::uint32_t)matrix.words, beam, hash, 0, 0, 0};
+    std::map<std::pair<std::uint32_t, std::uint32_t>, tree_t> done;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> units;  // to build
+    std::vector<std::uint32_t> all(matrix.words);
+    std::mutex lock;                      // guards done, file and progress
+    std::atomic<std::size_t> next{0};     // next unit to build
+    std::size_t finished = 0;             // units built or restored
+    auto start = clock::now();
+
+    for (std::uint32_t i = 0; i < matrix.words; ++i) {
+        all[i] = i;
+    }
+
+    std::vector<std::uint32_t> openings = beam_guesses(matrix, all, beam);
+    std::FILE* file = open_checkpoint(checkpoint, header, done);
+
+    if (!file) {
+        std::cerr << "Could not write " << checkpoint << ".\n";
+    }
+
+    // one unit per feedback to each opening, biggest groups first
+    std::vector<std::vector<std::uint32_t>> groups(
+        openings.size() * NUM_PATTERNS);
+
+    for (std::size_t o = 0; o < openings.size(); ++o) {
+        for (std::uint32_t answer : all) {
+            pattern_t p = matrix.at(openings[o], answer);
+
+            if (p != ALL_GREEN) {
+                groups[o * NUM_PATTERNS + p].push_back(answer);
+            }
+        }
+
+        for (std::uint32_t p = 0; p < NUM_PATTERNS; ++p) {
+            if (groups[o * NUM_PATTERNS + p].empty()) {
+                continue;
+            } else if (done.count({openings[o], p})) {
+                finished++;
+            } else {
+                units.push_back({(std::uint32_t)o, p});
+            }
+        }
+    }
+
+    std::sort(units.begin(), units.end(), [&groups](auto lhs, auto rhs) {
+        return groups[lhs.first * NUM_PATTERNS + lhs.second].size() >
+               groups[rhs.first * NUM_PATTERNS + rhs.second].size();
+    });
+
+    std::size_t total = finished + units.size();
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 0; t < workers; ++t) {
+        pool.emplace_back([&]() {
+            for (std::size_t u = next++; u < units.size(); u = next++) {
+                std::uint32_t o = units[u].first, p = units[u].second;
+                tree_t sub;
+
+                sub.cost = build_subtree(matrix,
+                                         groups[o * NUM_PATTERNS + p], beam,
+                                         1, NO_COST, sub);
+
+                std::lock_guard<std::mutex> guard(lock);
+                subtree_header_t entry{openings[o], p, sub.cost,
+                                       (std::uint32_t)sub.nodes.size(),
+                                       (std::uint32_t)(sub.edges.size() /
+                                                       NUM_PATTERNS)};
+
+                if (file) {
+                    std::fwrite(&entry, sizeof(entry), 1, file);
+                    std::fwrite(sub.nodes.data(), sizeof(tree_node_t),
+                                sub.nodes.size(), file);
+                    std::fwrite(sub.edges.data(), sizeof(std::uint32_t),
+                                sub.edges.size(), file);
+                    std::fflush(file);
+                }
+
+                done[{openings[o], p}] = std::move(sub);
+
+                std::cerr << "\r  subtrees " << ++finished << '/' << total
+                          << "  (" << (long)std::chrono::duration<double>(
+                                          clock::now() - start).count()
+                          << " s)" << std::flush;
+            }
+        });
+    }
+
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    std::cerr << '\n';
+
+    if (file) {
+        std::fclose(file);
+    }
+
+    // the cheapest opening, with every subtree solved
+    std::uint64_t best = NO_COST;
+
+    for (std::size_t o = 0; o < openings.size(); ++o) {
+        std::uint64_t cost = matrix.words;  // the opening, for every answer
+
+        for (std::uint32_t p = 0; p < NUM_PATTERNS && cost != NO_COST; ++p) {
+            if (!groups[o * NUM_PATTERNS + p].empty()) {
+                std::uint64_t spent = done[{openings[o], p}].cost;
+                cost = spent == NO_COST ? NO_COST : cost + spent;
+            }
+        }
+
+        if (cost >= best) {
+            continue;
+        }
+
+        best = cost;
+        tree = tree_t{};
+        tree.nodes.push_back({openings[o], 0});
+        tree.edges.assign(NUM_PATTERNS, NO_NODE);
+        tree.cost = matrix.words;
+
+        for (std::uint32_t p = 0; p < NUM_PATTERNS; ++p) {
+            if (!groups[o * NUM_PATTERNS + p].empty()) {
+                tree.edges[p] = graft(tree, done[{openings[o], p}]);
+            }
+        }
+    }
+
+    return best != NO_COST;
+}
+
+/// @brief Write a tree to a file.
+///
+/// @param path : The file to write (replaced atomically).
+/// @param tree : The tree.
+/// @param words : The number of words in the list.
+/// @param hash : hash_words() of the word list.
+/// @param beam : The number of guesses searched at each node.
+///
+/// @return whether the file was written.
+
+inline bool write_tree(const std::string& path, const tree_t& tree,
+                       std::uint32_t words, std::uint64_t hash,
+                       std::uint32_t beam) {
+    tree_header_t header{{'W', 'T', 'R', 'E'}, TREE_VERSION, words, beam,
+                         hash, tree.cost, (std::uint32_t)tree.nodes.size(),
+                         (std::uint32_t)(tree.edges.size() / NUM_PATTERNS)};
+    std::string temp = path + ".tmp";  // written first, then renamed
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+
+    if (!file) {
+        return false;
+    }
+
+    bool written =
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(tree.nodes.data(), sizeof(tree_node_t),
+                    tree.nodes.size(), file) == tree.nodes.size() &&
+        std::fwrite(tree.edges.data(), sizeof(std::uint32_t),
+                    tree.edges.size(), file) == tree.edges.size();
+
+    written = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Read a tree file built from the given word list.
+///
+/// @param path : The tree file.
+/// @param words : The number of words in the list.
+/// @param hash : hash_words() of the word list.
+/// @param tree : Receives the tree.
+///
+/// @return whether the file was a whole tree of this word list, every index
+/// in range.
+
+inline bool read_tree(const std::string& path, std::uint32_t words,
+                      std::uint64_t hash, tree_t& tree) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    tree_header_t header{};
+
+    if (!file) {
+        return false;
+    }
+
+    bool valid =
+        std::fread(&header, sizeof(header), 1, file) == 1 &&
+        std::memcmp(header.magic, "WTRE", 4) == 0 &&
+        header.version == TREE_VERSION && header.words == words &&
+        header.hash == hash && header.nodes &&
+        tree_fits(header.nodes, header.rows, words);
+
+    if (valid) {
+        tree.nodes.resize(header.nodes);
+        tree.edges.resize((std::size_t)header.rows * NUM_PATTERNS);
+        tree.cost = header.cost;
+
+        valid = std::fread(tree.nodes.data(), sizeof(tree_node_t),
+                           tree.nodes.size(), file) == tree.nodes.size() &&
+                std::fread(tree.edges.data(), sizeof(std::uint32_t),
+                           tree.edges.size(), file) == tree.edges.size() &&
+                valid_tree(tree, words);
+    }
+
+    std::fclose(file);
+    return valid;
+}
+
+#endif  // DECISION_TREE_HPP_
@@ -0,0 +1,439 @@
+/// @file Dictionary.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Compiled word list for Wordle.cpp: the packed words in alphabetical
+/// order with a minimal perfect hash for membership, memory mapped at startup
+/// with no parsing. Lookups never allocate or write, so one dictionary can be
+/// shared by any number of threads.
+///
+/// @note File layout: a dict_header_t, then 'count' packed words (4 or 8
+/// bytes each, by word length), then 'buckets' displacement seeds and 'count'
+/// slots, both uint32_t. A word hashes to a bucket; the bucket's seed sends it
+/// to its own slot, which holds the index of the word. The header records the
+/// word length, and the size and modification time of the text list it was
+/// compiled from, so an edited list is recompiled.
+
+#ifndef DICTIONARY_HPP_
+#define DICTIONARY_HPP_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::uint32_t DICT_VERSION = 2;        // bumped when the layout changes
+const std::uint32_t NOT_FOUND = 0xffffffff;  // index of a missing word
+const std::uint32_t MAX_SEED = 1u << 20;     // displacement search limit
+
+struct dict_header_t {
+    char magic[4];              // "WDIC"
+    std::uint32_t version;      // DICT_VERSION
+    std::uint32_t length;       // letters per word
+    std::uint32_t count;        // number of words
+    std::uint32_t buckets;      // number of displacement seeds
+    std::uint32_t unused;       // padding, written as 0
+    std::uint64_t source_size;  // size of the text list compiled
+    std::uint64_t source_time;  // modification time of the text list
+};
+
+template <int N = WORD_LEN>
+struct dictionary_t {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    const word_t* words = nullptr;           // packed words, alphabetical
+    const std::uint32_t* seeds = nullptr;    // displacement of each bucket
+    const std::uint32_t* slots = nullptr;    // word index held by each slot
+    std::size_t count = 0;                   // number of words
+    std::size_t buckets = 0;                 // number of buckets
+    void* base = nullptr;                    // start of the mapping, if mapped
+    std::size_t length = 0;                  // length of the mapping
+    std::vector<word_t> owned_words;         // words when not mapped
+    std::vector<std::uint32_t> owned_table;  // seeds, slots when not mapped
+
+    dictionary_t() = default;
+    dictionary_t(const dictionary_t&) = delete;
+    dictionary_t& operator=(const dictionary_t&) = delete;
+
+    ~dictionary_t() { close(); }
+
+    // index of a packed word, or NOT_FOUND
+    std::uint32_t find(word_t word) const;
+
+    // index of a word in either case, or NOT_FOUND
+    std::uint32_t find(const std::string& text) const {
+        word_t word{};
+        return pack<N>(text, word) ? find(word) : NOT_FOUND;
+    }
+
+    bool contains(word_t word) const { return find(word) != NOT_FOUND; }
+
+    bool contains(const std::string& text) const {
+        return find(text) != NOT_FOUND;
+    }
+
+    void close() {
+        if (base) {
+            ::munmap(base, length);
+        }
+
+        words = nullptr;
+        seeds = nullptr;
+        slots = nullptr;
+        count = 0;
+        buckets = 0;
+        base = nullptr;
+        length = 0;
+        owned_words.clear();
+        owned_table.clear();
+    }
+};
+
+// =============================================================================
+//  Hashing
+
+/// @brief Hash a packed word into a range.
+///
+/// @param word : The packed word.
+/// @param seed : Selects one of a family of hashes.
+/// @param range : The number of values.
+///
+/// @return a value from 0 to range - 1.
+
+inline std::uint32_t dict_hash(std::uint64_t word, std::uint32_t seed,
+                               std::size_t range) {
+    std::uint64_t hash = (word ^ seed * 0xd6e8feb86659fd93ULL) *
+                         0x9e3779b97f4a7c15ULL;
+
+    hash ^= hash >> 29;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 32;
+
+    return (std::uint32_t)(((hash & 0xffffffff) * range) >> 32);
+}
+
+template <int N>
+inline std::uint32_t dictionary_t<N>::find(word_t word) const {
+    if (!count) {
+        return NOT_FOUND;
+    }
+
+    std::uint32_t seed = seeds[dict_hash(word, 0, buckets)];
+    std::uint32_t index = slots[dict_hash(word, seed + 1, count)];
+
+    return words[index] == word ? index : NOT_FOUND;
+}
+
+/// @brief Order packed words alphabetically.
+///
+/// @param lhs : The first packed word.
+/// @param rhs : The second packed word.
+///
+/// @return whether lhs is spelled before rhs.
+
+template <int N = WORD_LEN>
+inline bool spelled_before(typename word_spec_t<N>::word_t lhs,
+                           typename word_spec_t<N>::word_t rhs) {
+    for (int i = 0; i < N; ++i) {
+        if (letter_at<N>(lhs, i) != letter_at<N>(rhs, i)) {
+            return letter_at<N>(lhs, i) < letter_at<N>(rhs, i);
+        }
+    }
+
+    return false;
+}
+
+// =============================================================================
+//  Compiling and Loading
+
+/// @brief Find the word length of a list: the length of the first word of
+/// the text list, or the length recorded in the compiled dictionary when
+/// there is no text list.
+///
+/// @param path : The compiled dictionary.
+/// @param source : The text list.
+///
+/// @return the word length, or 0 if neither file could be read.
+
+inline int list_length(const std::string& path, const std::string& source) {
+    std::ifstream text(source);
+    std::string entry;
+
+    if (text) {
+        return text >> entry ? (int)entry.length() : 0;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    dict_header_t header{};
+
+    if (
+        !file.read((char*)&header, sizeof(header)) ||
+        std::memcmp(header.magic, "WDIC", 4) != 0 ||
+        header.version != DICT_VERSION
+    ) {
+        return 0;
+    }
+
+    return (int)header.length;
+}
+
+/// @brief Compile a dictionary in memory.
+///
+/// @param list : The packed words, in any order, duplicates allowed.
+/// @param dict : Receives the dictionary.
+///
+/// @note Buckets are placed largest first, each trying seeds until all of
+/// its words land in free slots, so the late single-word buckets only need
+/// one free slot each.
+///
+/// @return whether a seed was found for every bucket.
+
+template <int N>
+bool compile_dictionary(std::vector<typename word_spec_t<N>::word_t> list,
+                        dictionary_t<N>& dict) {
+    std::sort(list.begin(), list.end(), spelled_before<N>);
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+
+    std::size_t count = list.size();
+    std::size_t buckets = count / 4 + 1;
+    std::vector<std::vector<std::uint32_t>> members(buckets);
+    std::vector<std::uint32_t> order(buckets);  // buckets, largest first
+    std::vector<char> taken(count);             // slots already assigned
+    std::vector<std::uint32_t> placed;          // slots of the bucket tried
+
+    dict.close();
+    dict.owned_words = std::move(list);
+    dict.owned_table.assign(buckets + count, 0);
+
+    const auto* words = dict.owned_words.data();
+    std::uint32_t* seeds = dict.owned_table.data();
+    std::uint32_t* slots = seeds + buckets;
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        members[dict_hash(words[i], 0, buckets)].push_back(i);
+    }
+
+    for (std::uint32_t b = 0; b < buckets; ++b) {
+        order[b] = b;
+    }
+
+    std::sort(order.begin(), order.end(),
+              [&](std::uint32_t lhs, std::uint32_t rhs) {
+                  return members[lhs].size() > members[rhs].size();
+              });
+
+    for (std::uint32_t b : order) {
+        std::uint32_t seed = 0;
+
+        // the rest are empty too; their seeds stay 0
+        if (members[b].empty()) {
+            break;
+        }
+
+        for (; seed < MAX_SEED; ++seed) {
+            placed.clear();
+
+            for (std::uint32_t i : members[b]) {
+                std::uint32_t slot = dict_hash(words[i], seed + 1, count);
+
+                if (taken[slot]) {
+                    break;
+                }
+
+                taken[slot] = 1;
+                placed.push_back(slot);
+            }
+
+            if (placed.size() == members[b].size()) {
+                break;
+            }
+
+            for (std::uint32_t slot : placed) {
+                taken[slot] = 0;
+            }
+        }
+
+        if (seed == MAX_SEED) {
+            dict.close();
+            return false;
+        }
+
+        seeds[b] = seed;
+
+        for (std::size_t k = 0; k < placed.size(); ++k) {
+            slots[placed[k]] = members[b][k];
+        }
+    }
+
+    dict.words = words;
+    dict.seeds = seeds;
+    dict.slots = slots;
+    dict.count = count;
+    dict.buckets = buckets;
+
+    return true;
+}
+
+/// @brief Compile a text word list and write the dictionary to a file.
+///
+/// @param path : The file to write (replaced atomically).
+/// @param source : The text list, one word per line; entries which are not
+/// N letters are skipped.
+/// @param dict : Receives the dictionary, held in memory.
+///
+/// @return whether the list was compiled (even if the file was not written).
+
+template <int N>
+bool build_dictionary(const std::string& path, const std::string& source,
+                      dictionary_t<N>& dict) {
+    std::ifstream text(source);
+    std::vector<typename word_spec_t<N>::word_t> list;
+    std::string entry;
+    typename word_spec_t<N>::word_t word{};
+    struct stat info{};
+
+    while (text >> entry) {
+        if (pack<N>(entry, word)) {
+            list.push_back(word);
+        }
+    }
+
+    if (!text.eof() || ::stat(source.c_str(), &info) != 0 ||
+        !compile_dictionary<N>(std::move(list), dict)) {
+        return false;
+    }
+
+    dict_header_t header{{'W', 'D', 'I', 'C'}, DICT_VERSION, N,
+                         (std::uint32_t)dict.count,
+                         (std::uint32_t)dict.buckets, 0,
+                         (std::uint64_t)info.st_size,
+                         (std::uint64_t)info.st_mtime};
+    std::string temp = path + ".tmp";  // written first, then renamed
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+
+    if (!file) {
+        return true;
+    }
+
+    bool written =
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(dict.owned_words.data(), sizeof(dict.owned_words[0]),
+                    dict.count, file) == dict.count &&
+        std::fwrite(dict.owned_table.data(), sizeof(std::uint32_t),
+                    dict.owned_table.size(), file) == dict.owned_table.size();
+
+    written = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+    }
+
+    return true;
+}
+
+/// @brief Map a dictionary file.
+///
+/// @param path : The file to map.
+/// @param source : The text list it must be current with; skipped when the
+/// text list does not exist.
+/// @param dict : Receives the mapping.
+///
+/// @note Every slot is checked to hold a word index, so a corrupt file is
+/// reported as invalid rather than read out of bounds by find().
+///
+/// @return whether a valid, current file of N-letter words was mapped.
+
+template <int N>
+bool map_dictionary(const std::string& path, const std::string& source,
+                    dictionary_t<N>& dict) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info{}, text{};
+    dict_header_t header{};
+
+    dict.close();
+
+    if (fd < 0) {
+        return false;
+    }
+
+    bool valid =
+        ::fstat(fd, &info) == 0 &&
+        ::read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+        std::memcmp(header.magic, "WDIC", 4) == 0 &&
+        header.version == DICT_VERSION && header.length == N &&
+        (std::size_t)info.st_size == sizeof(header) +
+            sizeof(word_t) * header.count +
+            sizeof(std::uint32_t) * ((std::size_t)header.count +
+                                     header.buckets) &&
+        (::stat(source.c_str(), &text) != 0 ||
+         ((std::uint64_t)text.st_size == header.source_size &&
+          (std::uint64_t)text.st_mtime == header.source_time));
+
+    void* base = valid ? ::mmap(nullptr, (std::size_t)info.st_size, PROT_READ,
+                                MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+
+    ::close(fd);
+
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    dict.base = base;
+    dict.length = (std::size_t)info.st_size;
+    dict.words = (const word_t*)((const char*)base + sizeof(header));
+    dict.count = header.count;
+    dict.buckets = header.buckets;
+    dict.seeds = (const std::uint32_t*)(dict.words + dict.count);
+    dict.slots = dict.seeds + dict.buckets;
+
+    // find() indexes seeds and words through the tables unchecked, so a
+    // corrupt table is caught here once and the file rebuilt
+    bool in_range = !dict.count || dict.buckets;
+
+    for (std::size_t i = 0; in_range && i < dict.count; ++i) {
+        in_range = dict.slots[i] < dict.count;
+    }
+
+    if (!in_range) {
+        dict.close();
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Map the compiled dictionary, or compile it from the text list
+/// (rewriting the file) when it is missing, stale or a rebuild is forced.
+///
+/// @param path : The compiled dictionary.
+/// @param source : The text list.
+/// @param dict : Receives the dictionary (held in memory when compiled).
+/// @param rebuild : Whether to recompile even a current file.
+///
+/// @return whether a dictionary was loaded.
+
+template <int N>
+bool load_dictionary(const std::string& path, const std::string& source,
+                     dictionary_t<N>& dict, bool rebuild = false) {
+    if (!rebuild && map_dictionary(path, source, dict)) {
+        return true;
+    }
+
+    return build_dictionary(path, source, dict);
+}
+
+#endif  // DICTIONARY_HPP_
@@ -0,0 +1,209 @@
+/// @file Feedback.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Feedback scoring kernel for Wordle.cpp: a scalar reference scorer
+/// and a bulk scorer which rates one guess against many packed answers at
+/// once (8 per step with AVX2 when the packed words fit 32 bits, otherwise a
+/// branch-free loop the compiler can vectorize). Both are templates on the
+/// word length N, defaulting to 5.
+
+#ifndef FEEDBACK_HPP_
+#define FEEDBACK_HPP_
+
+#include <cstddef>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "Words.hpp"
+
+// =============================================================================
+//  Reference Scorer
+
+/// @brief Score a guess against an answer.
+///
+/// @param guess : The packed guess.
+/// @param answer : The packed answer.
+///
+/// @note Greens are assigned first; a letter is then yellow only while the
+/// answer has copies of it not already claimed by a green or an earlier
+/// yellow.
+///
+/// @return the feedback pattern.
+
+template <int N = WORD_LEN>
+inline typename word_spec_t<N>::pattern_t score(
+    typename word_spec_t<N>::word_t guess,
+    typename word_spec_t<N>::word_t answer) {
+    int counts[26] {};   // answer letters not matched by a green
+    int digits[N] {};
+
+    for (int i = 0; i < N; ++i) {
+        if (letter_at<N>(guess, i) == letter_at<N>(answer, i)) {
+            digits[i] = 2;
+        } else {
+            counts[letter_at<N>(answer, i)]++;
+        }
+    }
+
+    for (int i = 0; i < N; ++i) {
+        if (digits[i] == 0 && counts[letter_at<N>(guess, i)] > 0) {
+            counts[letter_at<N>(guess, i)]--;
+            digits[i] = 1;
+        }
+    }
+
+    int code = 0;
+
+    for (int i = N - 1; i >= 0; --i) {
+        code = code * 3 + digits[i];
+    }
+
+    return (typename word_spec_t<N>::pattern_t)code;
+}
+
+// =============================================================================
+//  Bulk Scorer
+
+/// @brief Per-guess constants shared by every answer in a bulk call.
+///
+/// @note Position i of the guess is yellow exactly when it is not green and
+/// fewer earlier non-green positions hold the same letter than the answer has
+/// unmatched copies of it. 'same_before[i]' marks those earlier positions.
+
+template <int N = WORD_LEN>
+struct guess_plan_t {
+    int letters[N];      // letter index at each position
+    int same_before[N];  // bit k set: k < i and letters[k] == letters[i]
+
+    explicit guess_plan_t(typename word_spec_t<N>::word_t guess) {
+        for (int i = 0; i < N; ++i) {
+            letters[i] = letter_at<N>(guess, i);
+            same_before[i] = 0;
+
+            for (int k = 0; k < i; ++k) {
+                same_before[i] |= (letters[k] == letters[i]) << k;
+            }
+        }
+    }
+};
+
+/// @brief Branch-free scoring of one answer, the lane body of score_many().
+///
+/// @param plan : The prepared guess.
+/// @param answer : The packed answer.
+///
+/// @return the feedback pattern.
+
+template <int N>
+inline typename word_spec_t<N>::pattern_t score_lane(
+    const guess_plan_t<N>& plan, typename word_spec_t<N>::word_t answer) {
+    int letters[N];  // answer letters
+    int green[N];    // 1 where the guess matches the answer
+
+    for (int j = 0; j < N; ++j) {
+        letters[j] = letter_at<N>(answer, j);
+        green[j] = letters[j] == plan.letters[j];
+    }
+
+    int code = 0;
+
+    for (int i = 0; i < N; ++i) {
+        int avail = 0;  // unmatched copies of this letter in the answer
+        int rank = 0;   // earlier unmatched guess positions with this letter
+
+        for (int j = 0; j < N; ++j) {
+            avail += (letters[j] == plan.letters[i]) & !green[j];
+            rank += ((plan.same_before[i] >> j) & 1) & !green[j];
+        }
+
+        int yellow = !green[i] & (rank < avail);
+        code += (2 * green[i] + yellow) * pow3(i);
+    }
+
+    return (typename word_spec_t<N>::pattern_t)code;
+}
+
+/// @brief Score one guess against an array of answers.
+///
+/// @param guess : The packed guess.
+/// @param answers : The packed answers.
+/// @param count : The number of answers.
+/// @param out : Receives one feedback pattern per answer.
+
+template <int N = WORD_LEN>
+inline void score_many(typename word_spec_t<N>::word_t guess,
+                       const typename word_spec_t<N>::word_t* answers,
+                       std::size_t count,
+                       typename word_spec_t<N>::pattern_t* out) {
+    guess_plan_t<N> plan(guess);
+    std::size_t k = 0;
+
+#ifdef __AVX2__
+    using word = typename word_spec_t<N>::word_t;
+    using pattern = typename word_spec_t<N>::pattern_t;
+
+    const __m256i mask5 = _mm256_set1_epi32(31);
+    __m256i guess_at[N];  // guess letter at each position, broadcast
+
+    for (int i = 0; i < N; ++i) {
+        guess_at[i] = _mm256_set1_epi32(plan.letters[i]);
+    }
+
+    // 8 packed words per load only when they are 32 bits each
+    for (; sizeof(word) == 4 && k + 8 <= count; k += 8) {
+        __m256i packed = _mm256_loadu_si256((const __m256i*)(answers + k));
+        __m256i letters[N];  // answer letters, per lane
+        __m256i open[N];     // all ones where the position is not green
+        __m256i code = _mm256_setzero_si256();
+        int weight = 1;  // 3 ^ i
+
+        for (int j = 0; j < N; ++j) {
+            letters[j] = _mm256_and_si256(_mm256_srli_epi32(packed, 5 * j),
+                                          mask5);
+            open[j] = _mm256_xor_si256(
+                _mm256_cmpeq_epi32(letters[j], guess_at[j]),
+                _mm256_set1_epi32(-1));
+        }
+
+        for (int i = 0; i < N; ++i, weight *= 3) {
+            // both sums count down (each hit adds -1)
+            __m256i avail = _mm256_setzero_si256();
+            __m256i rank = _mm256_setzero_si256();
+
+            for (int j = 0; j < N; ++j) {
+                avail = _mm256_add_epi32(avail, _mm256_and_si256(
+                    _mm256_cmpeq_epi32(letters[j], guess_at[i]), open[j]));
+
+                if ((plan.same_before[i] >> j) & 1) {
+                    rank = _mm256_add_epi32(rank, open[j]);
+                }
+            }
+
+            // yellow: open and rank < avail, i.e. -rank > -avail
+            __m256i yellow = _mm256_and_si256(open[i],
+                                              _mm256_cmpgt_epi32(rank, avail));
+
+            code = _mm256_add_epi32(code, _mm256_andnot_si256(
+                open[i], _mm256_set1_epi32(2 * weight)));
+            code = _mm256_add_epi32(code, _mm256_and_si256(
+                yellow, _mm256_set1_epi32(weight)));
+        }
+
+        alignas(32) std::uint32_t codes[8];
+
+        _mm256_store_si256((__m256i*)codes, code);
+
+        for (int lane = 0; lane < 8; ++lane) {
+            out[k + lane] = (pattern)codes[lane];
+        }
+    }
+#endif
+
+    for (; k < count; ++k) {
+        out[k] = score_lane<N>(plan, answers[k]);
+    }
+}
+
+#endif  // FEEDBACK_HPP_
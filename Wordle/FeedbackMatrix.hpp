@@ -0,0 +1,251 @@
+/// @file FeedbackMatrix.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Precomputed guess x answer feedback matrix for Wordle.cpp, cached
+/// on disk and memory mapped so any (guess, answer) pair is one lookup.
+///
+/// @note File layout: a matrix_header_t, then one pattern_t per (guess,
+/// answer) pair, row by row, in word list order. The header records the word
+/// count and a hash of the packed word list, so a file built from a different
+/// list is detected and rebuilt.
+
+#ifndef FEEDBACK_MATRIX_HPP_
+#define FEEDBACK_MATRIX_HPP_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Feedback.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::uint32_t MATRIX_VERSION = 1;  // bumped when the layout changes
+
+struct matrix_header_t {
+    char magic[4];          // "WFBM"
+    std::uint32_t version;  // MATRIX_VERSION
+    std::uint32_t words;    // number of rows (and columns)
+    std::uint32_t unused;   // padding, written as 0
+    std::uint64_t hash;     // hash_words() of the word list
+};
+
+struct feedback_matrix_t {
+    const pattern_t* data = nullptr;  // words x words patterns
+    std::size_t words = 0;            // number of rows (and columns)
+    void* base = nullptr;             // start of the mapping, if mapped
+    std::size_t length = 0;           // length of the mapping
+    std::vector<pattern_t> owned;     // storage when not mapped
+
+    feedback_matrix_t() = default;
+    feedback_matrix_t(const feedback_matrix_t&) = delete;
+    feedback_matrix_t& operator=(const feedback_matrix_t&) = delete;
+
+    ~feedback_matrix_t() { close(); }
+
+    // feedback of guess number 'guess' against answer number 'answer'
+    pattern_t at(std::size_t guess, std::size_t answer) const {
+        return data[guess * words + answer];
+    }
+
+    // feedback of guess number 'guess' against every answer
+    const pattern_t* row(std::size_t guess) const {
+        return data + guess * words;
+    }
+
+    void close() {
+        if (base) {
+            ::munmap(base, length);
+        }
+
+        data = nullptr;
+        words = 0;
+        base = nullptr;
+        length = 0;
+        owned.clear();
+    }
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Hash a packed word list (64-bit FNV-1a over the packed words).
+///
+/// @param list : The packed words.
+///
+/// @return the hash.
+
+inline std::uint64_t hash_words(const std::vector<word_t>& list) {
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (word_t word : list) {
+        for (int byte = 0; byte < 4; ++byte) {
+            hash ^= (word >> (8 * byte)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+/// @brief Compute the feedback of every word against every word, splitting
+/// the rows across all hardware threads.
+///
+/// @param list : The packed words.
+/// @param out : Receives list.size() ^ 2 patterns, row by row.
+
+inline void compute_matrix(const std::vector<word_t>& list, pattern_t* out) {
+    std::size_t n = list.size();
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 0; t < workers; ++t) {
+        pool.emplace_back([&, t]() {
+            for (std::size_t g = t; g < n; g += workers) {
+                score_many(list[g], list.data(), n, out + g * n);
+            }
+        });
+    }
+
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+/// @brief Build the matrix for a word list and write it to a file.
+///
+/// @param path : The file to write (replaced atomically).
+/// @param list : The packed words.
+/// @param matrix : Receives the computed matrix, held in memory.
+///
+/// @return whether the file was written.
+
+inline bool build_matrix(const std::string& path,
+                         const std::vector<word_t>& list,
+                         feedback_matrix_t& matrix) {
+    matrix_header_t header{{'W', 'F', 'B', 'M'}, MATRIX_VERSION,
+                           (std::uint32_t)list.size(), 0, hash_words(list)};
+    std::string temp = path + ".tmp";  // written first, then renamed
+
+    matrix.close();
+    matrix.owned.resize(list.size() * list.size());
+    matrix.data = matrix.owned.data();
+    matrix.words = list.size();
+
+    compute_matrix(list, matrix.owned.data());
+
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+
+    if (!file) {
+        return false;
+    }
+
+    bool written =
+        std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+        std::fwrite(matrix.owned.data(), 1, matrix.owned.size(), file) ==
+            matrix.owned.size();
+
+    written = (std::fclose(file) == 0) && written;
+
+    if (!written || std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Map a matrix file, if it was built from this exact word list.
+///
+/// @param path : The file to map.
+/// @param list : The packed words the matrix must match.
+/// @param matrix : Receives the mapping.
+///
+/// @return whether a matching file was mapped.
+///
+/// @note The hash only detects another word list, so every pattern is also
+/// checked to be below NUM_PATTERNS.
+
+inline bool map_matrix(const std::string& path,
+                       const std::vector<word_t>& list,
+                       feedback_matrix_t& matrix) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info{};
+    matrix_header_t header{};
+    std::size_t expect = sizeof(header) + list.size() * list.size();
+
+    matrix.close();
+
+    if (fd < 0) {
+        return false;
+    }
+
+    bool valid =
+        ::fstat(fd, &info) == 0 && (std::size_t)info.st_size == expect &&
+        ::read(fd, &header, sizeof(header)) == (ssize_t)sizeof(header) &&
+        std::memcmp(header.magic, "WFBM", 4) == 0 &&
+        header.version == MATRIX_VERSION &&
+        header.words == list.size() &&
+        header.hash == hash_words(list);
+
+    void* base = valid ? ::mmap(nullptr, expect, PROT_READ, MAP_SHARED, fd, 0)
+                       : MAP_FAILED;
+
+    ::close(fd);
+
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    matrix.base = base;
+    matrix.length = expect;
+    matrix.data = (const pattern_t*)((const char*)base + sizeof(header));
+    matrix.words = list.size();
+
+    // rate_row() and build_subtree() count by pattern unchecked, so a
+    // corrupt file is caught here once and rebuilt
+    pattern_t top = 0;  // largest pattern in the file
+
+    for (std::size_t i = 0; i < matrix.words * matrix.words; ++i) {
+        top = std::max(top, matrix.data[i]);
+    }
+
+    if (top >= NUM_PATTERNS) {
+        matrix.close();
+        return false;
+    }
+
+    return true;
+}
+
+/// @brief Map the cached matrix for a word list, or rebuild it (rewriting
+/// the cache) when the cache is missing, stale or a rebuild is forced.
+///
+/// @param path : The cache file.
+/// @param list : The packed words.
+/// @param matrix : Receives the matrix (held in memory when it was built).
+/// @param rebuild : Whether to rebuild even a valid cache.
+
+inline void load_matrix(const std::string& path,
+                        const std::vector<word_t>& list,
+                        feedback_matrix_t& matrix, bool rebuild = false) {
+    if (!rebuild && map_matrix(path, list, matrix)) {
+        return;
+    }
+
+    // the freshly built matrix is used from memory; the file serves the
+    // next start
+    build_matrix(path, list, matrix);
+}
+
+#endif  // FEEDBACK_MATRIX_HPP_
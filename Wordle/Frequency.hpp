@@ -0,0 +1,153 @@
+/// @file Frequency.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Cheap guess ranking for Wordle.cpp from letter frequencies: how
+/// many candidates hold each letter, and each letter at each position, kept
+/// up to date as candidates are eliminated. Rating a guess is N lookups, so
+/// choosing one is linear in the word list instead of guesses x candidates.
+
+#ifndef FREQUENCY_HPP_
+#define FREQUENCY_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include "CandidateSet.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type Definitions
+
+template <int N = WORD_LEN>
+struct letter_table_t {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    std::uint32_t at[N][26] {};  // candidates with each letter at each place
+    std::uint32_t in[26] {};     // candidates holding each letter
+    std::uint32_t count = 0;     // candidates counted
+
+    // count a candidate, or forget one with 'sign' -1
+    void add(word_t word, int sign = 1) {
+        std::uint32_t seen = 0;  // letters of the word already counted
+
+        for (int i = 0; i < N; ++i) {
+            int letter = letter_at<N>(word, i);
+
+            at[i][letter] += (std::uint32_t)sign;
+
+            if (!((seen >> letter) & 1)) {
+                in[letter] += (std::uint32_t)sign;
+                seen |= 1u << letter;
+            }
+        }
+
+        count += (std::uint32_t)sign;
+    }
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Count every word of a set.
+///
+/// @param table : Receives the counts.
+/// @param words : The packed word list.
+/// @param candidates : The indices of the words to count.
+
+template <int N = WORD_LEN>
+void fill_table(letter_table_t<N>& table,
+                const std::vector<typename word_spec_t<N>::word_t>& words,
+                const candidate_set_t& candidates) {
+    table = letter_table_t<N>{};
+
+    for (std::uint32_t index : candidates.indices()) {
+        table.add(words[index]);
+    }
+}
+
+/// @brief Forget the words a feedback eliminated.
+///
+/// @param table : The counts of 'before', updated to those of 'after'.
+/// @param words : The packed word list.
+/// @param before : The candidates before the feedback.
+/// @param after : The candidates after it, a subset of 'before'.
+
+template <int N = WORD_LEN>
+void forget_eliminated(
+    letter_table_t<N>& table,
+    const std::vector<typename word_spec_t<N>::word_t>& words,
+    const candidate_set_t& before, const candidate_set_t& after) {
+    for (std::size_t b = 0; b < before.bits.size(); ++b) {
+        for (std::uint64_t gone = before.bits[b] & ~after.bits[b]; gone;
+             gone &= gone - 1) {
+            table.add(words[b * 64 + (std::size_t)__builtin_ctzll(gone)], -1);
+        }
+    }
+}
+
+/// @brief Rate a guess by how evenly its letters split the candidates: for
+/// each letter, the smaller of the candidates holding it and those not, and
+/// the same for the letter at its position.
+///
+/// @param table : The counts of the candidates.
+/// @param guess : The packed guess.
+///
+/// @return the rating, higher is better.
+
+template <int N = WORD_LEN>
+std::uint64_t frequency_score(const letter_table_t<N>& table,
+                              typename word_spec_t<N>::word_t guess) {
+    std::uint64_t score = 0;
+    std::uint32_t seen = 0;  // letters of the guess already rated
+
+    for (int i = 0; i < N; ++i) {
+        int letter = letter_at<N>(guess, i);
+
+        score += std::min(table.at[i][letter],
+                          table.count - table.at[i][letter]);
+
+        // a repeated letter tells nothing more about presence
+        if (!((seen >> letter) & 1)) {
+            score += std::min(table.in[letter], table.count - table.in[letter]);
+            seen |= 1u << letter;
+        }
+    }
+
+    return score;
+}
+
+/// @brief Choose the guess splitting the candidates best by letter
+/// frequency, preferring a candidate on ties.
+///
+/// @param words : The packed word list, every word allowed as a guess.
+/// @param table : The counts of the candidates.
+/// @param candidates : The indices of the candidates.
+///
+/// @return the index of the guess.
+
+template <int N = WORD_LEN>
+std::uint32_t frequency_guess(
+    const std::vector<typename word_spec_t<N>::word_t>& words,
+    const letter_table_t<N>& table, const candidate_set_t& candidates) {
+    std::uint32_t best = 0;        // index of the best guess so far
+    std::uint64_t best_score = 0;  // its rating
+    bool best_candidate = false;   // whether it could be the answer
+
+    for (std::uint32_t g = 0; g < words.size(); ++g) {
+        std::uint64_t score = frequency_score<N>(table, words[g]);
+        bool candidate = candidates.test(g);
+
+        if (
+            g == 0 || score > best_score ||
+            (score == best_score && candidate && !best_candidate)
+        ) {
+            best = g;
+            best_score = score;
+            best_candidate = candidate;
+        }
+    }
+
+    return best;
+}
+
+#endif  // FREQUENCY_HPP_
@@ -0,0 +1,268 @@
+/// @file GameLog.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Seeded answer selection and binary game logs for Wordle.cpp: every
+/// game draws its answer from one engine seeded up front, so a seed (or a
+/// date, for the daily word) reproduces the game, and the log of each game
+/// can be replayed headlessly against the current word list.
+///
+/// @note File layout: records appended back to back, each a log_game_t
+/// followed by 'count' log_guess_t. Both are fixed size and hold packed words
+/// (see Words.hpp), so a record is 32 bytes plus 16 per guess.
+
+#ifndef GAME_LOG_HPP_
+#define GAME_LOG_HPP_
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Dictionary.hpp"
+#include "Feedback.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::uint16_t LOG_VERSION = 1;  // bumped when the layout changes
+
+// the one engine a game draws from; its output is the same on every platform
+using engine_t = std::mt19937_64;
+
+struct log_game_t {
+    char magic[4];          // "WLOG", start of every record
+    std::uint16_t version;  // LOG_VERSION
+    std::uint8_t length;    // letters per word
+    std::uint8_t count;     // guesses following the record
+    std::uint64_t seed;     // seed of the engine which drew the answer
+    std::uint64_t answer;   // packed answer
+    std::uint64_t started;  // start of the game, seconds since the epoch
+};
+
+struct log_guess_t {
+    std::uint64_t word;     // packed guess
+    std::uint32_t millis;   // time taken to enter it
+    std::uint16_t pattern;  // feedback it received
+    std::uint16_t unused;   // padding, written as 0
+};
+
+struct game_log_t {
+    log_game_t game{};                 // the record, 'count' set on append
+    std::vector<log_guess_t> guesses;  // guesses on the board, in order
+};
+
+struct replay_result_t {
+    std::uint64_t games = 0;       // records of this word length replayed
+    std::uint64_t guesses = 0;     // guesses re-scored
+    std::uint64_t won = 0;         // games ending on a correct guess
+    std::uint64_t skipped = 0;     // records of another word length
+    std::uint64_t mismatches = 0;  // games whose answer or feedback differs
+    double seconds = 0;            // wall time of the replay
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Generate a random number between min and max.
+///
+/// @param engine : The engine to draw from.
+/// @param min : The lower bound of the generation range.
+/// @param max : The upper bound of the generation range.
+///
+/// @note Reduced by modulo rather than a distribution, whose output differs
+/// between standard libraries, so a seed picks the same number everywhere.
+///
+/// @return the generated value.
+
+inline int gen_random(engine_t& engine, int min, int max) {
+    return min + (int)(engine() % (std::uint64_t)(max - min + 1));
+}
+
+/// @brief Draw a word from the dictionary.
+///
+/// @param dict : The dictionary.
+/// @param engine : The engine to draw from.
+///
+/// @return the packed word.
+
+template <int N>
+typename word_spec_t<N>::word_t draw_word(const dictionary_t<N>& dict,
+                                          engine_t& engine) {
+    return dict.words[gen_random(engine, 0, (int)dict.count - 1)];
+}
+
+/// @brief Compute the seed of the daily word: the number of days from
+/// 1970-01-01 to the date.
+///
+/// @param date : The date as YYYY-MM-DD, or empty for today (local time).
+/// @param seed : Receives the seed.
+///
+/// @return whether the date was a calendar day from 1970 on.
+
+inline bool daily_seed(const std::string& date, std::uint64_t& seed) {
+    int year, month, day;
+    char extra;  // anything after the day
+
+    if (date.empty()) {
+        std::time_t now = std::time(nullptr);
+        std::tm local = *std::localtime(&now);
+
+        year = local.tm_year + 1900;
+        month = local.tm_mon + 1;
+        day = local.tm_mday;
+    } else if (
+        std::sscanf(date.c_str(), "%d-%d-%d%c", &year, &month, &day,
+                    &extra) != 3 ||
+        month < 1 || month > 12 || day < 1 || day > 31 || year < 1970
+    ) {
+        return false;
+    }
+
+    static const int MONTH_DAYS[12] = {31, 28, 31, 30, 31, 30,
+                                       31, 31, 30, 31, 30, 31};
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+
+    if (day > MONTH_DAYS[month - 1] + (month == 2 && leap)) {
+        return false;
+    }
+
+    // days of the civil calendar, counted from 0000-03-01 so that leap days
+    // fall at the end of each year
+    year -= month <= 2;
+
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long days = 365L * year + year / 4 - year / 100 + year / 400 + doy;
+
+    seed = (std::uint64_t)(days - 719468);  // 719468: 0000-03-01 to 1970
+    return true;
+}
+
+/// @brief Start the log of a game.
+///
+/// @param log : The log to reset.
+/// @param seed : The seed of the engine which drew the answer.
+/// @param answer : The packed answer.
+
+template <int N>
+void start_log(game_log_t& log, std::uint64_t seed,
+               typename word_spec_t<N>::word_t answer) {
+    log.game = {{'W', 'L', 'O', 'G'}, LOG_VERSION, N, 0, seed, answer,
+                (std::uint64_t)std::time(nullptr)};
+    log.guesses.clear();
+}
+
+/// @brief Append a finished game to a log file.
+///
+/// @param path : The log file, created if missing.
+/// @param log : The game.
+///
+/// @return whether the whole record was written.
+
+inline bool append_log(const std::string& path, game_log_t& log) {
+    if (log.guesses.size() > 255) {
+        return false;
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+
+    if (!file) {
+        return false;
+    }
+
+    log.game.count = (std::uint8_t)log.guesses.size();
+
+    // one write per record, so a crash leaves at most a torn tail
+    std::vector<char> record(sizeof(log.game) +
+                             log.guesses.size() * sizeof(log_guess_t));
+
+    std::memcpy(record.data(), &log.game, sizeof(log.game));
+    std::memcpy(record.data() + sizeof(log.game), log.guesses.data(),
+                log.guesses.size() * sizeof(log_guess_t));
+
+    bool written =
+        std::fwrite(record.data(), 1, record.size(), file) == record.size();
+
+    return (std::fclose(file) == 0) && written;
+}
+
+/// @brief Replay every game of a log file headlessly: check that each seed
+/// still draws the same answer and that each guess still gets the same
+/// feedback.
+///
+/// @param path : The log file.
+/// @param dict : The dictionary answers are drawn from.
+/// @param result : Receives the tally of the replay.
+///
+/// @return whether the file was read and every record was whole.
+
+template <int N>
+bool replay_log(const std::string& path, const dictionary_t<N>& dict,
+                replay_result_t& result) {
+    using clock = std::chrono::steady_clock;
+    using word_t = typename word_spec_t<N>::word_t;
+
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return false;
+    }
+
+    // read up front, so only the replay itself is timed
+    std::vector<char> data{std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>()};
+    std::size_t at = 0;  // offset of the next record
+
+    result = replay_result_t{};
+
+    auto start = clock::now();
+
+    while (at + sizeof(log_game_t) <= data.size()) {
+        log_game_t game;
+        log_guess_t guess{};
+
+        std::memcpy(&game, data.data() + at, sizeof(game));
+
+        std::size_t end = at + sizeof(game) + game.count * sizeof(guess);
+
+        if (
+            std::memcmp(game.magic, "WLOG", 4) != 0 ||
+            game.version != LOG_VERSION || end > data.size()
+        ) {
+            break;
+        } else if (game.length != N) {
+            result.skipped++;
+            at = end;
+            continue;
+        }
+
+        engine_t engine(game.seed);
+        word_t answer = draw_word(dict, engine);
+        bool same = answer == game.answer;  // whether the game replays alike
+
+        for (at += sizeof(game); at < end; at += sizeof(guess)) {
+            std::memcpy(&guess, data.data() + at, sizeof(guess));
+
+            same = same &&
+                   score<N>((word_t)guess.word, answer) == guess.pattern;
+        }
+
+        result.games++;
+        result.guesses += game.count;
+        result.won += game.count &&
+                      guess.pattern == word_spec_t<N>::all_green;
+        result.mismatches += !same;
+    }
+
+    result.seconds = std::chrono::duration<double>(clock::now() - start)
+                         .count();
+
+    return at == data.size();
+}
+
+#endif  // GAME_LOG_HPP_
@@ -0,0 +1,239 @@
+/// @file HintEngine.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Background hint engine for Wordle.cpp: ranks the next guesses on a
+/// worker thread as soon as the feedback of a turn is known, while the game
+/// waits on the player's input.
+///
+/// @note A new history cancels the ranking of the old one at its next check.
+/// Finished rankings are handed over through a single atomic slot, so taking
+/// the hints never waits on the worker. Once guesses x candidates passes
+/// HINT_EXACT the ranking is estimated by sampling (see Sampling.hpp).
+
+#ifndef HINT_ENGINE_HPP_
+#define HINT_ENGINE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Dictionary.hpp"
+#include "Feedback.hpp"
+#include "Library.hpp"
+#include "Sampling.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::size_t HINT_COUNT = 5;    // guesses ranked per hint
+const std::size_t HINT_CHECK = 64;   // guesses rated between cancel checks
+const std::size_t HINT_EXACT = 1 << 24;  // most pairs scored exactly
+
+template <int N>
+struct hint_t {
+    typename word_spec_t<N>::word_t guess;  // packed guess
+    double expected;                        // expected candidates left
+    bool candidate;                         // whether it could be the answer
+};
+
+template <int N>
+struct hint_result_t {
+    std::uint64_t generation = 0;   // history the hints are for
+    std::size_t candidates = 0;     // answers consistent with the history
+    std::vector<hint_t<N>> best;    // up to HINT_COUNT guesses, best first
+};
+
+template <int N>
+struct hint_engine_t {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    const dictionary_t<N>& dict;                   // guesses and answers
+    std::atomic<std::uint64_t> generation{0};      // latest history
+    std::atomic<hint_result_t<N>*> slot{nullptr};  // newest result, untaken
+    std::mutex lock;                               // guards history, stopping
+    std::condition_variable wake;                  // a history or a stop
+    std::vector<turn_t<N>> history;                // the latest history
+    bool stopping = false;                         // set to end the worker
+    std::thread worker;                            // started last
+
+    explicit hint_engine_t(const dictionary_t<N>& words)
+        : dict(words), worker([this] { run(); }) {}
+
+    hint_engine_t(const hint_engine_t&) = delete;
+    hint_engine_t& operator=(const hint_engine_t&) = delete;
+
+    ~hint_engine_t() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+            generation++;  // cancels a ranking in progress
+        }
+
+        wake.notify_one();
+        worker.join();
+        delete slot.exchange(nullptr);
+    }
+
+    // start ranking for a new history, cancelling the previous ranking;
+    // returns the generation its result will carry
+    std::uint64_t submit(const std::vector<turn_t<N>>& turns) {
+        std::uint64_t next;
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            history = turns;
+            next = ++generation;
+        }
+
+        wake.notify_one();
+        return next;
+    }
+
+    // newest finished result not taken yet, or null; never blocks
+    std::unique_ptr<hint_result_t<N>> take() {
+        return std::unique_ptr<hint_result_t<N>>(slot.exchange(nullptr));
+    }
+
+    void run() {
+        std::uint64_t done = 0;  // generation last ranked or cancelled
+
+        while (true) {
+            std::vector<turn_t<N>> turns;
+            std::uint64_t current;
+
+            {
+                std::unique_lock<std::mutex> guard(lock);
+
+                wake.wait(guard, [&] {
+                    return stopping || generation.load() != done;
+                });
+
+                if (stopping) {
+                    return;
+                }
+
+                turns = history;
+                current = generation.load();
+            }
+
+            if (hint_result_t<N>* result = rank(turns, current)) {
+                // an untaken older result is replaced
+                delete slot.exchange(result);
+            }
+
+            done = current;
+        }
+    }
+
+    // rank every word as the next guess; null if cancelled
+    hint_result_t<N>* rank(const std::vector<turn_t<N>>& turns,
+                           std::uint64_t current) const {
+        std::vector<word_t> candidates(dict.words, dict.words + dict.count);
+        typename word_spec_t<N>::pattern_t patterns[QUERY_BLOCK];
+        std::unique_ptr<hint_result_t<N>> result(new hint_result_t<N>);
+
+        filter_consistent<N>(candidates, turns);
+
+        result->generation = current;
+        result->candidates = candidates.size();
+
+        // each candidate splits the others best by itself
+        if (candidates.size() <= 2) {
+            for (word_t word : candidates) {
+                result->best.push_back({word, 1.0, true});
+            }
+
+            return result.release();
+        }
+
+        if (candidates.size() * dict.count > HINT_EXACT) {
+            return sample(candidates, current, result.release());
+        }
+
+        for (std::size_t g = 0; g < dict.count; ++g) {
+            if (g % HINT_CHECK == 0 && generation.load() != current) {
+                return nullptr;
+            }
+
+            std::uint32_t counts[word_spec_t<N>::patterns] {};
+            double squares = 0;  // sum of squared group sizes
+
+            for (std::size_t i = 0; i < candidates.size(); i += QUERY_BLOCK) {
+                std::size_t block = std::min(QUERY_BLOCK,
+                                             candidates.size() - i);
+
+                score_many<N>(dict.words[g], candidates.data() + i, block,
+                              patterns);
+
+                for (std::size_t k = 0; k < block; ++k) {
+                    counts[patterns[k]]++;
+                }
+            }
+
+            for (std::uint32_t count : counts) {
+                squares += (double)count * count;
+            }
+
+            hint_t<N> hint{dict.words[g],
+                           squares / (double)candidates.size(),
+                           counts[word_spec_t<N>::all_green] != 0};
+            auto& best = result->best;
+            auto at = best.end();  // where the hint ranks
+
+            // fewest expected left first, then guesses which could win
+            while (
+                at != best.begin() &&
+                (hint.expected < (at - 1)->expected ||
+                 (hint.expected == (at - 1)->expected && hint.candidate &&
+                  !(at - 1)->candidate))
+            ) {
+                --at;
+            }
+
+            if (at - best.begin() < (long)HINT_COUNT) {
+                best.insert(at, hint);
+
+                if (best.size() > HINT_COUNT) {
+                    best.pop_back();
+                }
+            }
+        }
+
+        return result.release();
+    }
+
+    // estimate the ranking by sampling the candidates; null if cancelled
+    hint_result_t<N>* sample(const std::vector<word_t>& candidates,
+                             std::uint64_t current,
+                             hint_result_t<N>* result) const {
+        std::unique_ptr<hint_result_t<N>> owned(result);
+        std::vector<word_t> guesses(dict.words, dict.words + dict.count);
+        std::vector<sample_rank_t> ranks = sample_guesses<N>(
+            guesses, candidates, HINT_COUNT, current,
+            std::max(1u, std::thread::hardware_concurrency()),
+            [&] { return generation.load() != current; });
+
+        if (ranks.empty()) {
+            return nullptr;
+        }
+
+        // candidates are filtered in dictionary order, so stay sorted
+        for (const sample_rank_t& rank : ranks) {
+            word_t guess = guesses[rank.guess];
+
+            result->best.push_back(
+                {guess, rank.expected,
+                 std::binary_search(candidates.begin(), candidates.end(),
+                                    guess, spelled_before<N>)});
+        }
+
+        return owned.release();
+    }
+};
+
+#endif  // HINT_ENGINE_HPP_
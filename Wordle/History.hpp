@@ -0,0 +1,302 @@
+/// @file History.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Append-only history of finished games for Wordle.cpp, with the
+/// aggregate statistics kept in a summary header updated on every append, so
+/// reading them never depends on the number of games played.
+///
+/// @note File layout: a history_header_t, then one history_record_t per
+/// finished game, oldest first. A record is appended before the header is
+/// rewritten; records past the count in the header (left by an interrupted
+/// append) are folded in the next time the file is opened.
+
+#ifndef HISTORY_HPP_
+#define HISTORY_HPP_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "GameLog.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::uint32_t HISTORY_VERSION = 1;  // bumped when the layout changes
+const int HISTORY_TURNS = 16;             // guess counts tallied, from 1
+const std::size_t SCAN_RECORDS = 4096;    // records read at once by a scan
+
+struct history_record_t {
+    std::uint64_t answer;    // packed answer
+    std::uint64_t finished;  // end of the game, seconds since the epoch
+    std::uint32_t guessed;   // letters guessed, bit 0 for 'A'
+    std::uint32_t missed;    // letters guessed but not in the answer
+    std::uint8_t length;     // letters per word
+    std::uint8_t turns;      // guesses made
+    std::uint8_t won;        // whether the last guess was the answer
+    std::uint8_t unused[5];  // padding, written as 0
+};
+
+struct history_header_t {
+    char magic[4];                        // "WHST"
+    std::uint32_t version;                // HISTORY_VERSION
+    std::uint64_t games;                  // records summarized below
+    std::uint64_t wins;                   // games won
+    std::uint64_t streak;                 // wins since the last loss
+    std::uint64_t best_streak;            // longest run of wins
+    std::uint64_t turns[HISTORY_TURNS];   // [n]: wins in n guesses, [0]:
+                                          // losses
+    std::uint64_t guessed[26];            // games each letter was guessed in
+    std::uint64_t missed[26];             // ... and was not in the answer
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Start the statistics of a history with no games.
+///
+/// @return the header of an empty history.
+
+inline history_header_t empty_history() {
+    history_header_t header{};
+
+    std::memcpy(header.magic, "WHST", 4);
+    header.version = HISTORY_VERSION;
+
+    return header;
+}
+
+/// @brief Summarize a finished game as a history record.
+///
+/// @param log : The log of the game.
+///
+/// @return the record.
+
+template <int N>
+history_record_t history_record(const game_log_t& log) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    history_record_t record{};
+    std::uint32_t present = 0;  // letters of the answer
+
+    for (int i = 0; i < N; ++i) {
+        present |= 1u << letter_at<N>((word_t)log.game.answer, i);
+    }
+
+    for (const log_guess_t& guess : log.guesses) {
+        for (int i = 0; i < N; ++i) {
+            record.guessed |= 1u << letter_at<N>((word_t)guess.word, i);
+        }
+    }
+
+    record.answer = log.game.answer;
+    record.finished = (std::uint64_t)std::time(nullptr);
+    record.missed = record.guessed & ~present;
+    record.length = N;
+    record.turns = (std::uint8_t)log.guesses.size();
+    record.won = !log.guesses.empty() &&
+                 log.guesses.back().pattern == word_spec_t<N>::all_green;
+
+    return record;
+}
+
+/// @brief Add one game to the aggregate statistics.
+///
+/// @param header : The statistics, updated.
+/// @param record : The game, newer than every game already summarized.
+
+inline void fold_record(history_header_t& header,
+                        const history_record_t& record) {
+    header.games++;
+
+    if (record.won) {
+        header.wins++;
+        header.streak++;
+        header.best_streak = std::max(header.best_streak, header.streak);
+        header.turns[std::min<int>(record.turns, HISTORY_TURNS - 1)]++;
+    } else {
+        header.streak = 0;
+        header.turns[0]++;
+    }
+
+    for (int letter = 0; letter < 26; ++letter) {
+        header.guessed[letter] += (record.guessed >> letter) & 1;
+        header.missed[letter] += (record.missed >> letter) & 1;
+    }
+}
+
+/// @brief Fold records from a history file into the statistics, reading
+/// them in blocks.
+///
+/// @param file : The history file.
+/// @param header : The statistics, updated.
+/// @param first : The index of the first record to fold.
+/// @param last : One past the index of the last record to fold.
+///
+/// @return whether every record was read.
+
+inline bool fold_records(std::FILE* file, history_header_t& header,
+                         std::uint64_t first, std::uint64_t last) {
+    std::vector<history_record_t> block(SCAN_RECORDS);
+
+    if (std::fseek(file, (long)(sizeof(header) + first * sizeof(block[0])),
+                   SEEK_SET) != 0) {
+        return false;
+    }
+
+    while (first < last) {
+        std::size_t want = (std::size_t)std::min<std::uint64_t>(
+            last - first, SCAN_RECORDS);
+
+        if (std::fread(block.data(), sizeof(block[0]), want, file) != want) {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < want; ++i) {
+            fold_record(header, block[i]);
+        }
+
+        first += want;
+    }
+
+    return true;
+}
+
+/// @brief Open a history file and read its statistics, folding in any
+/// records an interrupted append left out of them.
+///
+/// @param path : The history file.
+/// @param header : Receives the statistics.
+/// @param create : Whether to create the file if it is missing.
+///
+/// @return the open file, or nullptr if it is missing or not a history.
+
+inline std::FILE* open_history(const std::string& path,
+                               history_header_t& header, bool create) {
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+
+    header = empty_history();
+
+    if (!file && create && (file = std::fopen(path.c_str(), "w+b"))) {
+        if (std::fwrite(&header, sizeof(header), 1, file) == 1) {
+            return file;
+        }
+    }
+
+    if (
+        !file || std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, "WHST", 4) != 0 ||
+        header.version != HISTORY_VERSION ||
+        std::fseek(file, 0, SEEK_END) != 0
+    ) {
+        if (file) {
+            std::fclose(file);
+        }
+        return nullptr;
+    }
+
+    // whole records on disk; a torn tail is overwritten by the next append
+    std::uint64_t stored = ((std::uint64_t)std::ftell(file) - sizeof(header))
+                           / sizeof(history_record_t);
+
+    if (stored > header.games && !fold_records(file, header, header.games,
+                                               stored)) {
+        std::fclose(file);
+        return nullptr;
+    }
+
+    return file;
+}
+
+/// @brief Write the statistics over the header of a history file.
+///
+/// @param file : The history file.
+/// @param header : The statistics.
+///
+/// @return whether they were written.
+
+inline bool write_header(std::FILE* file, const history_header_t& header) {
+    return std::fseek(file, 0, SEEK_SET) == 0 &&
+           std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+           std::fflush(file) == 0;
+}
+
+/// @brief Append a finished game to a history file and update its
+/// statistics.
+///
+/// @param path : The history file, created if missing.
+/// @param record : The game.
+/// @param header : Receives the updated statistics.
+///
+/// @return whether the game was recorded.
+
+inline bool append_history(const std::string& path,
+                           const history_record_t& record,
+                           history_header_t& header) {
+    std::FILE* file = open_history(path, header, true);
+
+    if (!file) {
+        return false;
+    }
+
+    // the record first, so the header never counts a missing record
+    bool written =
+        std::fseek(file, (long)(sizeof(header) + header.games *
+                                sizeof(record)), SEEK_SET) == 0 &&
+        std::fwrite(&record, sizeof(record), 1, file) == 1 &&
+        std::fflush(file) == 0;
+
+    if (written) {
+        fold_record(header, record);
+        written = write_header(file, header);
+    }
+
+    return (std::fclose(file) == 0) && written;
+}
+
+/// @brief Read the statistics of a history file from its header.
+///
+/// @param path : The history file.
+/// @param header : Receives the statistics.
+///
+/// @return whether the file was a readable history.
+
+inline bool read_history(const std::string& path, history_header_t& header) {
+    std::FILE* file = open_history(path, header, false);
+
+    return file && std::fclose(file) == 0;
+}
+
+/// @brief Recompute the statistics of a history file from every record, in
+/// one streaming pass, and write them over its header.
+///
+/// @param path : The history file.
+/// @param header : Receives the statistics.
+///
+/// @return whether every record was read and the header written.
+
+inline bool rescan_history(const std::string& path,
+                           history_header_t& header) {
+    std::FILE* file = open_history(path, header, false);
+
+    if (!file) {
+        return false;
+    }
+
+    // every whole record on disk, even if the header was damaged
+    bool written = std::fseek(file, 0, SEEK_END) == 0;
+    std::uint64_t stored = ((std::uint64_t)std::ftell(file) - sizeof(header))
+                           / sizeof(history_record_t);
+
+    header = empty_history();
+    written = written && fold_records(file, header, 0, stored) &&
+              write_header(file, header);
+
+    return (std::fclose(file) == 0) && written;
+}
+
+#endif  // HISTORY_HPP_
@@ -0,0 +1,201 @@
+/// @file Library.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Wordle analysis library: a word list with its answer set, and
+/// scoring, feedback histograms and filtering by guess history, for tools
+/// which include this header instead of running Wordle.cpp.
+///
+/// @note Nothing here prints, reads input or keeps global state. Loading a
+/// library touches the disk only through load_dictionary(); once loaded it is
+/// never written, so any number of threads may query one library at once.
+
+#ifndef LIBRARY_HPP_
+#define LIBRARY_HPP_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Dictionary.hpp"
+#include "Feedback.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::size_t QUERY_BLOCK = 1024;  // answers scored per kernel call
+
+template <int N = WORD_LEN>
+struct turn_t {
+    typename word_spec_t<N>::word_t guess;        // packed guess
+    typename word_spec_t<N>::pattern_t pattern;   // feedback it received
+};
+
+template <int N = WORD_LEN>
+struct library_t {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    dictionary_t<N> dict;          // the words allowed as guesses
+    std::vector<word_t> answers;   // the words queries range over, every
+                                   // word of the dictionary unless narrowed
+};
+
+// =============================================================================
+//  Loading
+
+/// @brief Load a library from a compiled dictionary, compiling it from the
+/// text list if needed (see load_dictionary()).
+///
+/// @param path : The compiled dictionary.
+/// @param source : The text list.
+/// @param lib : Receives the library, with every word as an answer.
+///
+/// @return whether the dictionary was loaded.
+
+template <int N = WORD_LEN>
+bool open_library(const std::string& path, const std::string& source,
+                  library_t<N>& lib) {
+    if (!load_dictionary(path, source, lib.dict) || !lib.dict.count) {
+        return false;
+    }
+
+    lib.answers.assign(lib.dict.words, lib.dict.words + lib.dict.count);
+    return true;
+}
+
+/// @brief Build a library in memory from a list of words.
+///
+/// @param words : The words, in either case; entries which are not N letters
+/// are skipped.
+/// @param lib : Receives the library, with every word as an answer.
+///
+/// @return whether any word was kept.
+
+template <int N = WORD_LEN>
+bool make_library(const std::vector<std::string>& words, library_t<N>& lib) {
+    std::vector<typename word_spec_t<N>::word_t> list;
+    typename word_spec_t<N>::word_t word{};
+
+    for (const std::string& text : words) {
+        if (pack<N>(text, word)) {
+            list.push_back(word);
+        }
+    }
+
+    if (!compile_dictionary<N>(std::move(list), lib.dict) || !lib.dict.count) {
+        return false;
+    }
+
+    lib.answers.assign(lib.dict.words, lib.dict.words + lib.dict.count);
+    return true;
+}
+
+/// @brief Read one turn of a history.
+///
+/// @param guess : The guess, N letters in either case.
+/// @param feedback : Its feedback, as accepted by parse_pattern().
+/// @param turn : Receives the turn.
+///
+/// @return whether both were valid.
+
+template <int N = WORD_LEN>
+bool parse_turn(const std::string& guess, const std::string& feedback,
+                turn_t<N>& turn) {
+    return pack<N>(guess, turn.guess) &&
+           parse_pattern<N>(feedback, turn.pattern);
+}
+
+// =============================================================================
+//  Queries
+
+/// @brief Count the answers giving each feedback to a guess.
+///
+/// @param lib : The library.
+/// @param guess : The packed guess (need not be in the dictionary).
+/// @param counts : Receives the number of answers per feedback pattern.
+
+template <int N = WORD_LEN>
+void pattern_histogram(const library_t<N>& lib,
+                       typename word_spec_t<N>::word_t guess,
+                       std::uint32_t counts[word_spec_t<N>::patterns]) {
+    typename word_spec_t<N>::pattern_t patterns[QUERY_BLOCK];
+
+    std::fill(counts, counts + word_spec_t<N>::patterns, 0);
+
+    for (std::size_t i = 0; i < lib.answers.size(); i += QUERY_BLOCK) {
+        std::size_t block = std::min(QUERY_BLOCK, lib.answers.size() - i);
+
+        score_many<N>(guess, lib.answers.data() + i, block, patterns);
+
+        for (std::size_t k = 0; k < block; ++k) {
+            counts[patterns[k]]++;
+        }
+    }
+}
+
+/// @brief Check one word against a history.
+///
+/// @param word : The packed word.
+/// @param history : The turns played.
+///
+/// @return whether the word would have given every feedback of the history.
+
+template <int N = WORD_LEN>
+bool is_consistent(typename word_spec_t<N>::word_t word,
+                   const std::vector<turn_t<N>>& history) {
+    for (const turn_t<N>& turn : history) {
+        if (score<N>(turn.guess, word) != turn.pattern) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Keep only the words consistent with a history.
+///
+/// @param words : The packed words, filtered in place, order kept.
+/// @param history : The turns played.
+
+template <int N = WORD_LEN>
+void filter_consistent(std::vector<typename word_spec_t<N>::word_t>& words,
+                       const std::vector<turn_t<N>>& history) {
+    typename word_spec_t<N>::pattern_t patterns[QUERY_BLOCK];
+
+    for (const turn_t<N>& turn : history) {
+        std::size_t kept = 0;  // words consistent so far
+
+        // kept never passes i, so each block is scored before it is written
+        for (std::size_t i = 0; i < words.size(); i += QUERY_BLOCK) {
+            std::size_t block = std::min(QUERY_BLOCK, words.size() - i);
+
+            score_many<N>(turn.guess, words.data() + i, block, patterns);
+
+            for (std::size_t k = 0; k < block; ++k) {
+                if (patterns[k] == turn.pattern) {
+                    words[kept++] = words[i + k];
+                }
+            }
+        }
+
+        words.resize(kept);
+    }
+}
+
+/// @brief Find the answers consistent with a history.
+///
+/// @param lib : The library.
+/// @param history : The turns played.
+///
+/// @return the packed answers, in the order of lib.answers.
+
+template <int N = WORD_LEN>
+std::vector<typename word_spec_t<N>::word_t> consistent_answers(
+    const library_t<N>& lib, const std::vector<turn_t<N>>& history) {
+    std::vector<typename word_spec_t<N>::word_t> words = lib.answers;
+
+    filter_consistent<N>(words, history);
+    return words;
+}
+
+#endif  // LIBRARY_HPP_
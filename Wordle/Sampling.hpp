@@ -0,0 +1,306 @@
+/// @file Sampling.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Monte Carlo guess ranking for Wordle.cpp, for word lists too large
+/// to score every guess against every candidate each turn: the expected
+/// candidates left by each guess is estimated from random batches of
+/// candidates, and sampling stops once the best guesses are separated from
+/// the rest by their confidence bounds.
+///
+/// @note Each batch is drawn without replacement, so the share of its pairs
+/// of candidates sharing a feedback is an unbiased estimate of the share over
+/// every pair; the mean of the batches and its standard error give the
+/// bounds. Every guess is rated on the same batches, and only guesses whose
+/// bounds still overlap the best get more of them.
+
+#ifndef SAMPLING_HPP_
+#define SAMPLING_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "Feedback.hpp"
+#include "GameLog.hpp"
+#include "Library.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::size_t SAMPLE_BATCH = 64;          // candidates per batch
+const std::size_t SAMPLE_MIN_BATCHES = 8;     // batches every guess gets
+const std::size_t SAMPLE_MAX_BATCHES = 512;   // batches before giving up
+const double SAMPLE_Z = 2.58;                 // bounds: 99% two-sided
+
+struct sample_rank_t {
+    std::uint32_t guess;     // index of the guess in the guess list
+    double expected;         // estimated expected candidates left
+    double margin;           // half-width of its confidence interval
+    std::size_t batches;     // batches rated, 0 if rated exactly
+    double sum;              // sum of the batch estimates
+    double squares;          // sum of their squares
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Estimate the expected candidates left by a guess from one batch.
+///
+/// @param patterns : The feedbacks of a batch from draw_batches().
+/// @param total : The number of candidates.
+/// @param counts : Scratch per feedback pattern, all zero; left all zero.
+///
+/// @return the estimate.
+
+template <int N>
+double batch_estimate(const typename word_spec_t<N>::pattern_t* patterns,
+                      std::size_t total, std::uint16_t* counts) {
+    std::uint64_t pairs = 0;  // ordered pairs of the batch sharing feedback
+
+    for (std::size_t k = 0; k < SAMPLE_BATCH; ++k) {
+        pairs += 2 * counts[patterns[k]]++;
+    }
+
+    for (std::size_t k = 0; k < SAMPLE_BATCH; ++k) {
+        counts[patterns[k]] = 0;
+    }
+
+    // an answer's group holds itself and each other candidate sharing its
+    // feedback; the batch's pairs are a uniform sample of distinct pairs
+    return 1.0 + (double)(total - 1) * (double)pairs /
+                     (double)(SAMPLE_BATCH * (SAMPLE_BATCH - 1));
+}
+
+/// @brief Count the expected candidates left by a guess exactly.
+///
+/// @param guess : The packed guess.
+/// @param candidates : The packed candidates, at least one.
+///
+/// @return the sum of the squared feedback group sizes over the number of
+/// candidates.
+
+template <int N>
+double exact_expected(
+    typename word_spec_t<N>::word_t guess,
+    const std::vector<typename word_spec_t<N>::word_t>& candidates) {
+    std::vector<std::uint32_t> sizes(word_spec_t<N>::patterns);
+    typename word_spec_t<N>::pattern_t patterns[QUERY_BLOCK];
+    double squares = 0;
+
+    for (std::size_t i = 0; i < candidates.size(); i += QUERY_BLOCK) {
+        std::size_t block = std::min(QUERY_BLOCK, candidates.size() - i);
+
+        score_many<N>(guess, candidates.data() + i, block, patterns);
+
+        for (std::size_t k = 0; k < block; ++k) {
+            sizes[patterns[k]]++;
+        }
+    }
+
+    for (std::uint32_t size : sizes) {
+        squares += (double)size * size;
+    }
+
+    return squares / (double)candidates.size();
+}
+
+/// @brief Draw batches of candidates, each without replacement.
+///
+/// @param candidates : The packed candidates, at least SAMPLE_BATCH.
+/// @param batches : The number of batches to draw.
+/// @param engine : Draws the batches.
+/// @param deck : The candidate indices in any order, shuffled in part for
+/// each batch (filled if not one per candidate).
+/// @param sample : Receives the batches, appended back to back.
+
+template <int N>
+void draw_batches(
+    const std::vector<typename word_spec_t<N>::word_t>& candidates,
+    std::size_t batches, engine_t& engine, std::vector<std::uint32_t>& deck,
+    std::vector<typename word_spec_t<N>::word_t>& sample) {
+    if (deck.size() != candidates.size()) {
+        deck.resize(candidates.size());
+        std::iota(deck.begin(), deck.end(), 0u);
+    }
+
+    // a partial Fisher-Yates shuffle: the first SAMPLE_BATCH places of any
+    // permutation become a uniform draw of distinct candidates
+    for (std::size_t b = 0; b < batches; ++b) {
+        for (std::size_t k = 0; k < SAMPLE_BATCH; ++k) {
+            std::size_t pick = k + (std::size_t)gen_random(
+                engine, 0, (int)(deck.size() - 1 - k));
+
+            std::swap(deck[k], deck[pick]);
+            sample.push_back(candidates[deck[k]]);
+        }
+    }
+}
+
+/// @brief Rank guesses by the expected number of candidates left, exactly
+/// for small candidate sets and by sampling otherwise.
+///
+/// @param guesses : The packed guesses.
+/// @param candidates : The packed candidates.
+/// @param top : The number of best guesses to separate and return.
+/// @param seed : Seeds the engine drawing the batches.
+/// @param workers : The number of threads rating guesses.
+/// @param stop : Checked between rounds; ranking is abandoned when true.
+///
+/// @return up to 'top' rankings, best first, or none if stopped.
+
+template <int N, typename stop_t>
+std::vector<sample_rank_t> sample_guesses(
+    const std::vector<typename word_spec_t<N>::word_t>& guesses,
+    const std::vector<typename word_spec_t<N>::word_t>& candidates,
+    std::size_t top, std::uint64_t seed, unsigned workers, stop_t stop) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    std::size_t total = candidates.size();
+    std::vector<sample_rank_t> ranks(guesses.size());
+    std::vector<std::uint32_t> alive(guesses.size());  // not yet separated
+    std::vector<word_t> sample;   // the batches, back to back
+    std::vector<std::uint32_t> deck;  // candidate indices batches come from
+    bool exact = total <= SAMPLE_BATCH * SAMPLE_MIN_BATCHES;
+    engine_t engine(seed);
+
+    if (guesses.empty() || !total) {
+        return {};
+    }
+
+    for (std::uint32_t g = 0; g < guesses.size(); ++g) {
+        ranks[g] = {g, 0, 0, 0, 0, 0};
+        alive[g] = g;
+    }
+
+    workers = std::max(1u, workers);
+    top = std::min(top, guesses.size());
+
+    // rate each live guess on the batches it has not seen
+    auto rate = [&](unsigned t) {
+        std::vector<std::uint16_t> counts(word_spec_t<N>::patterns);
+        typename word_spec_t<N>::pattern_t patterns[QUERY_BLOCK];
+
+        for (std::size_t a = t; a < alive.size(); a += workers) {
+            sample_rank_t& rank = ranks[alive[a]];
+            word_t guess = guesses[rank.guess];
+
+            if (exact) {
+                // few enough to count every group exactly
+                rank.expected = exact_expected<N>(guess, candidates);
+                continue;
+            }
+
+            // QUERY_BLOCK holds whole batches
+            for (std::size_t i = rank.batches * SAMPLE_BATCH;
+                 i < sample.size(); i += QUERY_BLOCK) {
+                std::size_t block = std::min(QUERY_BLOCK, sample.size() - i);
+
+                score_many<N>(guess, sample.data() + i, block, patterns);
+
+                for (std::size_t k = 0; k < block; k += SAMPLE_BATCH) {
+                    double estimate = batch_estimate<N>(patterns + k, total,
+                                                        counts.data());
+
+                    rank.sum += estimate;
+                    rank.squares += estimate * estimate;
+                    rank.batches++;
+                }
+            }
+
+            double mean = rank.sum / (double)rank.batches;
+            double spread = std::max(0.0, rank.squares /
+                                     (double)rank.batches - mean * mean);
+
+            rank.expected = mean;
+            rank.margin = SAMPLE_Z * std::sqrt(spread /
+                                               (double)(rank.batches - 1));
+        }
+    };
+
+    auto by_estimate = [&ranks](std::uint32_t lhs, std::uint32_t rhs) {
+        if (ranks[lhs].expected != ranks[rhs].expected) {
+            return ranks[lhs].expected < ranks[rhs].expected;
+        }
+
+        return lhs < rhs;
+    };
+
+    for (std::size_t round = SAMPLE_MIN_BATCHES; !alive.empty();
+         round *= 2) {
+        if (stop()) {
+            return {};
+        }
+
+        // batches are drawn once, shared by every guess
+        std::size_t batches = std::min(round, SAMPLE_MAX_BATCHES);
+
+        if (!exact) {
+            draw_batches<N>(candidates,
+                            batches - sample.size() / SAMPLE_BATCH, engine,
+                            deck, sample);
+        }
+
+        std::vector<std::thread> pool;
+
+        for (unsigned t = 1; t < workers; ++t) {
+            pool.emplace_back(rate, t);
+        }
+
+        rate(0);
+
+        for (auto& worker : pool) {
+            worker.join();
+        }
+
+        if (exact) {
+            break;
+        }
+
+        // a guess stays live while it could still rank among the top: its
+        // lower bound reaches the 'top'-th best upper bound
+        std::vector<double> uppers;
+
+        for (std::uint32_t g : alive) {
+            uppers.push_back(ranks[g].expected + ranks[g].margin);
+        }
+
+        std::nth_element(uppers.begin(), uppers.begin() + (long)(top - 1),
+                         uppers.end());
+
+        double cutoff = uppers[top - 1];
+
+        alive.erase(std::remove_if(alive.begin(), alive.end(),
+                                   [&](std::uint32_t g) {
+                                       return ranks[g].expected -
+                                                  ranks[g].margin > cutoff;
+                                   }),
+                    alive.end());
+
+        if (alive.size() <= top || batches == SAMPLE_MAX_BATCHES) {
+            break;
+        }
+    }
+
+    // the separated guesses, best first
+    std::vector<std::uint32_t> order(guesses.size());
+
+    for (std::uint32_t g = 0; g < guesses.size(); ++g) {
+        order[g] = g;
+    }
+
+    std::partial_sort(order.begin(), order.begin() + (long)top, order.end(),
+                      by_estimate);
+
+    std::vector<sample_rank_t> best;
+
+    for (std::size_t i = 0; i < top; ++i) {
+        best.push_back(ranks[order[i]]);
+    }
+
+    return best;
+}
+
+#endif  // SAMPLING_HPP_
@@ -0,0 +1,302 @@
+/// @file SelfTest.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Self-checks for Wordle.cpp's --selftest mode: the bulk scorer
+/// against the reference scorer, on hand-worked duplicate-letter cases and
+/// on every pair of a word list, through both the AVX2 and the scalar path;
+/// and the sampling ranker against exact expected values.
+
+#ifndef SELF_TEST_HPP_
+#define SELF_TEST_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Feedback.hpp"
+#include "Sampling.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+// the bulk scorer never takes its 8-lane path for fewer answers than this
+const std::size_t SCALAR_BLOCK = 7;
+
+struct score_case_t {
+    const char* guess;     // the guess
+    const char* answer;    // the answer
+    const char* feedback;  // worked out by hand, as parse_pattern() reads it
+};
+
+// repeated letters in the guess, the answer or both
+const score_case_t SCORE_CASES[] = {
+    {"BOOB",    "OBOE",    "yyg."},
+    {"EERIE",   "SPEED",   "yy..."},
+    {"SPEED",   "EERIE",   "..yy."},
+    {"SPEED",   "ABIDE",   "..y.y"},
+    {"LLAMA",   "ABBEY",   "..y.."},
+    {"LLAMA",   "LOYAL",   "gyy.."},
+    {"BOBBY",   "ABBEY",   "y.g.g"},
+    {"ABBEY",   "KEBAB",   "yygy."},
+    {"EERIE",   "EERIE",   "ggggg"},
+    {"LLAMAS",  "SALAAM",  "y.yygy"},
+    {"ABSCESS", "SUCCESS", "..ygggg"},
+};
+
+const std::size_t BIAS_BATCHES = 4096;  // batches averaged per bias check
+const double BIAS_LIMIT = 4.0;          // standard errors a mean may be off
+const std::size_t SAMPLE_RUNS = 20;     // seeds the ranker is checked with
+const std::size_t SAMPLE_TOP = 5;       // guesses ranked per run
+const double SAMPLE_COVERAGE = 0.9;     // share of 99% intervals required
+
+struct sampling_result_t {
+    double bias = 0;            // worst batch mean error, in standard errors
+    std::size_t rated = 0;      // rankings returned over every run
+    std::size_t covered = 0;    // of them, intervals holding the exact value
+    std::size_t runs = 0;       // rankings run
+    std::size_t found = 0;      // of them, those keeping the exact best guess
+};
+
+struct check_result_t {
+    std::uint64_t pairs = 0;       // guess/answer pairs checked
+    std::uint64_t mismatches = 0;  // patterns which disagreed
+    std::string first;             // the first disagreement, if any
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Whether score_many() scores N-letter words 8 at a time.
+///
+/// @return whether the AVX2 path is compiled in for N.
+
+template <int N>
+constexpr bool bulk_avx2() {
+#ifdef __AVX2__
+    return sizeof(typename word_spec_t<N>::word_t) == 4;
+#else
+    return false;
+#endif
+}
+
+/// @brief Record one disagreement between the scorers.
+///
+/// @param result : The tally.
+/// @param path : The scorer which disagreed.
+/// @param guess : The packed guess.
+/// @param answer : The packed answer.
+/// @param got : The pattern it gave.
+/// @param want : The pattern expected.
+
+template <int N>
+void mismatch(check_result_t& result, const char* path,
+              typename word_spec_t<N>::word_t guess,
+              typename word_spec_t<N>::word_t answer, int got, int want) {
+    if (!result.mismatches++) {
+        result.first = std::string(path) + ": " + unpack<N>(guess) + " / " +
+                       unpack<N>(answer) + " gave ";
+        format_pattern<N>(got, result.first);
+        result.first += ", expected ";
+        format_pattern<N>(want, result.first);
+    }
+}
+
+/// @brief Cut or repeat each word of a list to N letters, so one list checks
+/// every word length.
+///
+/// @param words : The words.
+///
+/// @return the packed N-letter words, in spelling order without repeats.
+
+template <int N>
+std::vector<typename word_spec_t<N>::word_t> stretch_words(
+    const std::vector<std::string>& words) {
+    std::vector<typename word_spec_t<N>::word_t> list;
+    typename word_spec_t<N>::word_t word{};
+
+    for (const std::string& text : words) {
+        std::string stretched;
+
+        while (!text.empty() && stretched.size() < N) {
+            stretched += text;
+        }
+
+        if (pack<N>(stretched.substr(0, N), word)) {
+            list.push_back(word);
+        }
+    }
+
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+
+    return list;
+}
+
+/// @brief Check every scorer on the hand-worked cases of N letters.
+///
+/// @param result : Receives the tally, added to.
+
+template <int N>
+void check_cases(check_result_t& result) {
+    using word_t = typename word_spec_t<N>::word_t;
+    using pattern_t = typename word_spec_t<N>::pattern_t;
+
+    for (const score_case_t& test : SCORE_CASES) {
+        word_t guess{}, answer{};
+        pattern_t want{};
+        word_t answers[8];     // enough for one 8-lane step
+        pattern_t patterns[8];
+
+        if (std::strlen(test.guess) != N) {
+            continue;
+        }
+
+        pack<N>(test.guess, guess);
+        pack<N>(test.answer, answer);
+        parse_pattern<N>(test.feedback, want);
+        std::fill(answers, answers + 8, answer);
+
+        result.pairs++;
+
+        if (score<N>(guess, answer) != want) {
+            mismatch<N>(result, "score", guess, answer,
+                        score<N>(guess, answer), want);
+        }
+
+        score_many<N>(guess, answers, 8, patterns);
+
+        if (patterns[7] != want) {
+            mismatch<N>(result, "score_many", guess, answer, patterns[7],
+                        want);
+        }
+
+        score_many<N>(guess, answers, 1, patterns);
+
+        if (patterns[0] != want) {
+            mismatch<N>(result, "score_many scalar", guess, answer,
+                        patterns[0], want);
+        }
+    }
+}
+
+/// @brief Check the bulk scorer against score() on every pair of a list,
+/// scoring the whole list at once (the AVX2 path where compiled) and in
+/// blocks too short for it (the scalar path).
+///
+/// @param words : The packed words, each a guess and an answer.
+/// @param result : Receives the tally, added to.
+
+template <int N>
+void check_scoring(const std::vector<typename word_spec_t<N>::word_t>& words,
+                   check_result_t& result) {
+    using pattern_t = typename word_spec_t<N>::pattern_t;
+
+    std::vector<pattern_t> bulk(words.size());    // whole list at once
+    std::vector<pattern_t> scalar(words.size());  // SCALAR_BLOCK at a time
+
+    for (auto guess : words) {
+        score_many<N>(guess, words.data(), words.size(), bulk.data());
+
+        for (std::size_t i = 0; i < words.size(); i += SCALAR_BLOCK) {
+            score_many<N>(guess, words.data() + i,
+                          std::min(SCALAR_BLOCK, words.size() - i),
+                          scalar.data() + i);
+        }
+
+        for (std::size_t a = 0; a < words.size(); ++a) {
+            pattern_t want = score<N>(guess, words[a]);
+
+            if (bulk[a] != want) {
+                mismatch<N>(result, "score_many", guess, words[a], bulk[a],
+                            want);
+            }
+
+            if (scalar[a] != want) {
+                mismatch<N>(result, "score_many scalar", guess, words[a],
+                            scalar[a], want);
+            }
+        }
+
+        result.pairs += words.size();
+    }
+}
+
+/// @brief Check the sampling ranker against exact expected values: that the
+/// mean of many batch estimates matches the exact value for the best, median
+/// and worst guess, and that across seeds the confidence intervals hold the
+/// exact values and the stopping rule keeps the exact best guess.
+///
+/// @param guesses : The packed guesses.
+/// @param candidates : The packed candidates, too many to be rated exactly.
+/// @param result : Receives the tally.
+
+template <int N>
+void check_sampling(
+    const std::vector<typename word_spec_t<N>::word_t>& guesses,
+    const std::vector<typename word_spec_t<N>::word_t>& candidates,
+    sampling_result_t& result) {
+    std::vector<double> exact(guesses.size());
+    std::vector<std::uint32_t> order(guesses.size());  // best guess first
+
+    for (std::size_t g = 0; g < guesses.size(); ++g) {
+        exact[g] = exact_expected<N>(guesses[g], candidates);
+        order[g] = (std::uint32_t)g;
+    }
+
+    std::sort(order.begin(), order.end(),
+              [&](std::uint32_t lhs, std::uint32_t rhs) {
+                  return exact[lhs] < exact[rhs];
+              });
+
+    // the estimator alone: a plain mean of batches
+    for (std::uint32_t g : {order.front(), order[order.size() / 2],
+                            order.back()}) {
+        std::vector<typename word_spec_t<N>::word_t> sample;
+        std::vector<std::uint32_t> deck;
+        std::vector<std::uint16_t> counts(word_spec_t<N>::patterns);
+        typename word_spec_t<N>::pattern_t patterns[SAMPLE_BATCH];
+        engine_t engine(g);
+        double sum = 0, squares = 0;
+
+        draw_batches<N>(candidates, BIAS_BATCHES, engine, deck, sample);
+
+        for (std::size_t b = 0; b < BIAS_BATCHES; ++b) {
+            score_many<N>(guesses[g], sample.data() + b * SAMPLE_BATCH,
+                          SAMPLE_BATCH, patterns);
+
+            double estimate = batch_estimate<N>(patterns, candidates.size(),
+                                                counts.data());
+
+            sum += estimate;
+            squares += estimate * estimate;
+        }
+
+        double mean = sum / BIAS_BATCHES;
+        double error = std::sqrt(std::max(0.0, squares / BIAS_BATCHES -
+                                                   mean * mean) /
+                                 (BIAS_BATCHES - 1));
+
+        result.bias = std::max(result.bias, std::fabs(mean - exact[g]) /
+                                                std::max(error, 1e-9));
+    }
+
+    // the ranker: its intervals and its stopping rule
+    for (std::uint64_t seed = 1; seed <= SAMPLE_RUNS; ++seed) {
+        std::vector<sample_rank_t> ranks = sample_guesses<N>(
+            guesses, candidates, SAMPLE_TOP, seed, 1, [] { return false; });
+
+        result.runs++;
+
+        for (const sample_rank_t& rank : ranks) {
+            result.rated++;
+            result.covered += std::fabs(rank.expected - exact[rank.guess]) <=
+                              rank.margin;
+            result.found += rank.guess == order.front();
+        }
+    }
+}
+
+#endif  // SELF_TEST_HPP_
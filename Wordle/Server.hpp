@@ -0,0 +1,294 @@
+/// @file Server.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Headless multi-game server for Wordle.cpp: many concurrent games
+/// held in a fixed slab of sessions, driven by a newline-delimited protocol
+/// over stdin or a Unix domain socket.
+///
+/// @note Protocol, one reply line per request line:
+///     NEW [answer]        -> OK <id>
+///     GUESS <id> <word>   -> OK <feedback> <PLAYING | WON | LOST [answer]>
+///     STATE <id>          -> OK <PLAYING | WON | LOST> <turns>
+///                               [<guess> <feedback>]... [answer]
+///     DROP <id>           -> OK
+///     QUIT                   (closes the connection)
+/// Failures reply "ERROR <reason>". Feedback is one character per letter:
+/// 'g' green, 'y' yellow, '.' gray. A game belongs to the connection which
+/// started it: other connections get "ERROR no session" for its id, and its
+/// slot is freed when that connection quits or hangs up.
+
+#ifndef SERVER_HPP_
+#define SERVER_HPP_
+
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "../LineServer.hpp"
+#include "Dictionary.hpp"
+#include "Feedback.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type and Constant Definitions
+
+const std::size_t SLAB_SESSIONS = 1 << 16;  // concurrent games per server
+const std::size_t LOCK_STRIPES = 64;        // session locks, by slot
+
+template <int N, int GUESSES>
+struct session_t {
+    using word_t = typename word_spec_t<N>::word_t;
+    using pattern_t = typename word_spec_t<N>::pattern_t;
+
+    word_t answer = 0;                 // packed answer
+    word_t guesses[GUESSES] {};        // packed guesses, in order
+    pattern_t patterns[GUESSES] {};    // feedback of each guess
+    int count = 0;                     // guesses made
+    std::uint32_t generation = 0;      // bumped whenever the slot is freed
+    bool live = false;                 // whether the slot holds a game
+
+    bool won() const {
+        return count && patterns[count - 1] == word_spec_t<N>::all_green;
+    }
+
+    bool over() const { return won() || count == GUESSES; }
+};
+
+// A session id is the slot index in the low 32 bits and the slot generation
+// in the high 32 bits, so the id of a dropped game never reaches its
+// successor in the same slot.
+template <int N, int GUESSES>
+struct session_slab_t {
+    std::vector<session_t<N, GUESSES>> slots;  // every session, live or free
+    std::vector<std::uint32_t> free_slots;     // slots not holding a game
+    std::mutex free_lock;                      // guards free_slots
+    std::mutex locks[LOCK_STRIPES];            // guards slots[i], i % STRIPES
+
+    session_slab_t() : slots(SLAB_SESSIONS), free_slots(SLAB_SESSIONS) {
+        // lowest slots first
+        for (std::size_t i = 0; i < SLAB_SESSIONS; ++i) {
+            free_slots[i] = (std::uint32_t)(SLAB_SESSIONS - 1 - i);
+        }
+    }
+
+    // start a game; false when every slot is taken
+    bool open(typename word_spec_t<N>::word_t answer, std::uint64_t& id) {
+        std::uint32_t slot;
+
+        {
+            std::lock_guard<std::mutex> guard(free_lock);
+
+            if (free_slots.empty()) {
+                return false;
+            }
+
+            slot = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        std::lock_guard<std::mutex> guard(locks[slot % LOCK_STRIPES]);
+        session_t<N, GUESSES>& session = slots[slot];
+
+        session.answer = answer;
+        session.count = 0;
+        session.live = true;
+        id = (std::uint64_t)session.generation << 32 | slot;
+
+        return true;
+    }
+
+    // run 'use' on the live session 'id' under its lock; false if none
+    template <typename use_t>
+    bool with(std::uint64_t id, use_t use) {
+        std::uint32_t slot = (std::uint32_t)id;
+
+        if (slot >= slots.size()) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> guard(locks[slot % LOCK_STRIPES]);
+        session_t<N, GUESSES>& session = slots[slot];
+
+        if (!session.live || session.generation != (std::uint32_t)(id >> 32)) {
+            return false;
+        }
+
+        use(session);
+        return true;
+    }
+
+    // end a game and free its slot; false if 'id' is not live
+    bool close(std::uint64_t id) {
+        bool closed = with(id, [](session_t<N, GUESSES>& session) {
+            session.live = false;
+            session.generation++;
+        });
+
+        if (closed) {
+            std::lock_guard<std::mutex> guard(free_lock);
+            free_slots.push_back((std::uint32_t)id);
+        }
+
+        return closed;
+    }
+};
+
+// One connection's view of the server (see LineServer.hpp): the games live
+// in the shared slab, but only the connection which started a game may play
+// it, and its games are dropped when it ends.
+template <int N, int GUESSES>
+struct game_session_t {
+    session_slab_t<N, GUESSES>& slab;  // the sessions, shared
+    const dictionary_t<N>& dict;       // answers and guesses must be in it
+    std::unordered_set<std::uint64_t> games;  // ids started here, live
+
+    game_session_t(session_slab_t<N, GUESSES>& sessions,
+                   const dictionary_t<N>& words)
+        : slab(sessions), dict(words) {}
+
+    // the games move with the connection, so only one copy frees them
+    game_session_t(game_session_t&& other)
+        : slab(other.slab), dict(other.dict), games(std::move(other.games)) {
+        other.games.clear();
+    }
+
+    // a connection dropped for a failed write never reaches finish()
+    ~game_session_t() { release(); }
+
+    bool take(const std::string& line, std::string& reply);
+    void finish(std::string&) { release(); }
+
+    // free the slot of every game still held
+    void release() {
+        for (std::uint64_t id : games) {
+            slab.close(id);
+        }
+
+        games.clear();
+    }
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Carry out one request line.
+///
+/// @param slab : The sessions.
+/// @param dict : The dictionary answers and guesses must be in.
+/// @param games : The ids of the connection's games, the only ones it may
+/// play; updated by NEW and DROP.
+/// @param line : The request.
+/// @param reply : Receives the reply line, appended.
+
+template <int N, int GUESSES>
+void handle_request(session_slab_t<N, GUESSES>& slab,
+                    const dictionary_t<N>& dict,
+                    std::unordered_set<std::uint64_t>& games,
+                    const std::string& line, std::string& reply) {
+    thread_local std::mt19937_64 rng{std::random_device{}()};
+
+    std::istringstream args(line);  // command keyword and arguments
+    std::string keyword, word;      // command keyword, word argument
+    std::uint64_t id = 0;           // session argument
+    std::uint32_t index = 0;        // dictionary index of the word argument
+
+    args >> keyword;
+
+    if (keyword == "NEW") {
+        if (!(args >> word)) {
+            index = (std::uint32_t)(rng() % dict.count);
+        } else if ((index = dict.find(word)) == NOT_FOUND) {
+            reply += "ERROR unknown word\n";
+            return;
+        }
+
+        if (!slab.open(dict.words[index], id)) {
+            reply += "ERROR no free session\n";
+            return;
+        }
+
+        games.insert(id);
+        reply += "OK " + std::to_string(id) + '\n';
+    } else if (keyword == "GUESS") {
+        typename word_spec_t<N>::word_t guess{};
+
+        if (!(args >> id >> word)) {
+            reply += "ERROR malformed GUESS\n";
+        } else if (!pack<N>(word, guess) || !dict.contains(guess)) {
+            reply += "ERROR unknown word\n";
+        } else if (!games.count(id) ||
+                   !slab.with(id, [&](session_t<N, GUESSES>& session) {
+            if (session.over()) {
+                reply += "ERROR game over\n";
+                return;
+            }
+
+            auto pattern = score<N>(guess, session.answer);
+
+            session.guesses[session.count] = guess;
+            session.patterns[session.count++] = pattern;
+
+            reply += "OK ";
+            format_pattern<N>(pattern, reply);
+            if (session.won()) {
+                reply += " WON\n";
+            } else if (session.over()) {
+                reply += " LOST " + unpack<N>(session.answer) + '\n';
+            } else {
+                reply += " PLAYING\n";
+            }
+        })) {
+            reply += "ERROR no session\n";
+        }
+    } else if (keyword == "STATE") {
+        if (!(args >> id)) {
+            reply += "ERROR malformed STATE\n";
+        } else if (!games.count(id) ||
+                   !slab.with(id, [&](session_t<N, GUESSES>& session) {
+            reply += session.won() ? "OK WON " :
+                     session.over() ? "OK LOST " : "OK PLAYING ";
+            reply += std::to_string(session.count);
+
+            for (int i = 0; i < session.count; ++i) {
+                reply += ' ' + unpack<N>(session.guesses[i]) + ' ';
+                format_pattern<N>(session.patterns[i], reply);
+            }
+
+            if (session.over()) {
+                reply += ' ' + unpack<N>(session.answer);
+            }
+
+            reply += '\n';
+        })) {
+            reply += "ERROR no session\n";
+        }
+    } else if (keyword == "DROP") {
+        if (!(args >> id)) {
+            reply += "ERROR malformed DROP\n";
+        } else {
+            bool dropped = games.erase(id) && slab.close(id);
+
+            reply += dropped ? "OK\n" : "ERROR no session\n";
+        }
+    } else {
+        reply += "ERROR unknown command " + keyword + '\n';
+    }
+}
+
+template <int N, int GUESSES>
+bool game_session_t<N, GUESSES>::take(const std::string& line,
+                                      std::string& reply) {
+    if (line == "QUIT") {
+        release();
+        return false;
+    } else if (!line.empty()) {
+        handle_request(slab, dict, games, line, reply);
+    }
+
+    return true;
+}
+
+#endif  // SERVER_HPP_
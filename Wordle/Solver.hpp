@@ -0,0 +1,140 @@
+/// @file Solver.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Guess ranking by expected remaining candidates for Wordle.cpp.
+
+#ifndef SOLVER_HPP_
+#define SOLVER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "FeedbackMatrix.hpp"
+#include "Words.hpp"
+
+// =============================================================================
+//  Type Definitions
+
+struct rank_t {
+    std::uint32_t guess;    // index of the guess in the guess list
+    double expected;        // expected candidates left after the guess
+    double entropy;         // expected information of the feedback, in bits
+    bool candidate;         // whether the guess could be the answer itself
+};
+
+// =============================================================================
+//  Function Definitions
+
+/// @brief Order rankings from best to worst: fewest expected candidates
+/// left, then guesses which could win outright, then most information.
+///
+/// @param lhs : The first ranking.
+/// @param rhs : The second ranking.
+///
+/// @return whether lhs ranks strictly before rhs.
+
+inline bool ranks_before(const rank_t& lhs, const rank_t& rhs) {
+    if (lhs.expected != rhs.expected) {
+        return lhs.expected < rhs.expected;
+    } else if (lhs.candidate != rhs.candidate) {
+        return lhs.candidate;
+    } else if (lhs.entropy != rhs.entropy) {
+        return lhs.entropy > rhs.entropy;
+    }
+
+    return lhs.guess < rhs.guess;
+}
+
+/// @brief Rate a guess from the number of candidates giving each feedback.
+///
+/// @param index : The index of the guess in the guess list.
+/// @param buckets : The number of candidates per feedback pattern.
+/// @param total : The number of candidates.
+///
+/// @return the rating of the guess.
+
+inline rank_t rate_buckets(std::uint32_t index,
+                           const std::uint32_t buckets[NUM_PATTERNS],
+                           std::size_t total) {
+    double sum_sq = 0;      // sum of squared bucket sizes
+    double sum_info = 0;    // sum of size * log2(size) over buckets
+
+    for (int pattern = 0; pattern < NUM_PATTERNS; ++pattern) {
+        if (buckets[pattern]) {
+            double size = buckets[pattern];
+
+            sum_sq += size * size;
+            sum_info += size * std::log2(size);
+        }
+    }
+
+    return {
+        index,
+        total ? sum_sq / (double)total : 0,
+        total ? std::log2((double)total) - sum_info / (double)total : 0,
+        buckets[ALL_GREEN] != 0
+    };
+}
+
+/// @brief Rate one word of a feedback matrix as a guess, looking up its
+/// feedback against each candidate.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param guess : The index of the guess.
+/// @param candidates : The indices of the words which could be the answer.
+///
+/// @return the rating of the guess.
+
+inline rank_t rate_row(const feedback_matrix_t& matrix, std::uint32_t guess,
+                       const std::vector<std::uint32_t>& candidates) {
+    std::uint32_t buckets[NUM_PATTERNS] {};  // candidates per feedback
+    const pattern_t* row = matrix.row(guess);
+
+    for (std::uint32_t answer : candidates) {
+        buckets[row[answer]]++;
+    }
+
+    return rate_buckets(guess, buckets, candidates.size());
+}
+
+/// @brief Rank every word of a feedback matrix as a guess against the
+/// remaining candidates, looking each feedback up instead of scoring it.
+///
+/// @param matrix : The feedback matrix of the word list.
+/// @param candidates : The indices of the words which could be the answer.
+/// @param top : The number of best guesses to return.
+///
+/// @note The guesses are split across all hardware threads.
+///
+/// @return up to 'top' rankings, best first.
+
+inline std::vector<rank_t> rank_guesses(
+    const feedback_matrix_t& matrix,
+    const std::vector<std::uint32_t>& candidates, std::size_t top) {
+    std::vector<rank_t> ranks(matrix.words);
+    unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+
+    for (unsigned t = 0; t < workers; ++t) {
+        pool.emplace_back([&, t]() {
+            for (std::size_t g = t; g < matrix.words; g += workers) {
+                ranks[g] = rate_row(matrix, (std::uint32_t)g, candidates);
+            }
+        });
+    }
+
+    for (auto& worker : pool) {
+        worker.join();
+    }
+
+    top = std::min(top, ranks.size());
+    std::partial_sort(ranks.begin(), ranks.begin() + (long)top, ranks.end(),
+                      ranks_before);
+    ranks.resize(top);
+
+    return ranks;
+}
+
+#endif  // SOLVER_HPP_
@@ -9,28 +9,76 @@
 // =============================================================================
 //  Library Includes
 
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
 #include <cstdlib>
-#include <ctime>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <random>
 #include <sstream>
 #include <string>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 // =============================================================================
 //  Local Includes
 
 #include "../ansi.hpp"
+#include "Absurdle.hpp"
+#include "Bench.hpp"
+#include "CandidateSet.hpp"
+#include "DecisionTree.hpp"
+#include "Dictionary.hpp"
+#include "Feedback.hpp"
+#include "FeedbackMatrix.hpp"
+#include "GameLog.hpp"
+#include "HintEngine.hpp"
+#include "History.hpp"
+#include "SelfTest.hpp"
+#include "Server.hpp"
+#include "Solver.hpp"
+#include "Words.hpp"
 
 // =============================================================================
 //  Global Data Definitions
 
-// Board information
-#define MAX_GUESSES 7
+// Board information: guesses allowed for words of N letters (7 for 5)
+template <int N>
+constexpr int max_guesses = N + 2;
+
+// Number of ranked guesses shown by the solver
+#define SHOW_GUESSES 10
+
+// Cache of the feedback of every word against every word
+#define MATRIX_FILE "feedback.bin"
+
+// Decision tree played by --tree, and the checkpoint of its builder
+#define TREE_FILE "tree.bin"
+#define TREE_CHECKPOINT "tree.ckpt"
+
+// Guesses searched at each node of the decision tree, unless given
+#define TREE_BEAM 3
+
+// Word list, and the compiled dictionary mapped in its place
+#define WORD_FILE "wordslist.txt"
+#define DICT_FILE "words.bin"
+
+// Binary log every game is appended to, replayed by --replay
+#define LOG_FILE "games.log"
+
+// Finished games and their statistics, shown by --stats
+#define HISTORY_FILE "history.bin"
+
+// Guesses allowed on K boards at once (9 for 4 boards of 5 letters)
+template <int N, int K>
+constexpr int multi_guesses = max_guesses<N> + K - 2;
+
+// Screen line of the first board row, from 1: below it are the other rows,
+// a gap, the status message and the prompt
+#define BOARD_LINE 2
 
 // Return id values
 #define SUCCESS 0  // successfully add guess to board
@@ -39,36 +87,38 @@
 // =============================================================================
 //  Global Variables
 
+template <int N, int G>
 struct board_t {
-    char goal[6] {};                        // Goal word of game
-    char guesses[MAX_GUESSES][5] {};        // MAX_GUESSES rows * (5 letters)
-    std::unordered_map<char, int> letters;  // map chars to count in goal word
+    char goal[N + 1] {};                    // Goal word of game
+    char guesses[G][N] {};                  // G rows * (N letters)
+    std::string rows[G];                    // Rendered rows, once filled
     int num_guesses{};                      // Number of guesses in board
 
     void clear() {
         for (int i = 0; i < num_guesses; ++i) {
-            for (int j = 0; j < 5; ++j) {
+            for (int j = 0; j < N; ++j) {
                 guesses[i][j] = '\0';
             }
+
+            rows[i].clear();
         }
 
-        letters.clear();
+        num_guesses = 0;
 
-        for (int i = 0; i < 5; ++i) {
+        for (int i = 0; i < N; ++i) {
             goal[i] = '\0';
         }
     }
 
     void set_goal(std::string& word) {
-        for (int i = 0; i < 5; ++i) {
-            goal[i] = word[i];
-            letters[word.at(i)]++;
+        for (int i = 0; i < N; ++i) {
+            goal[i] = word.at(i);
         }
     }
 
     int add_word(std::string& word) {
-        if (num_guesses < MAX_GUESSES) {
-            for (int col = 0; col < 5; ++col) {
+        if (num_guesses < G) {
+            for (int col = 0; col < N; ++col) {
                 guesses[num_guesses][col] = word.at(col);
             }
         } else {
@@ -78,17 +128,11 @@ struct board_t {
         ++num_guesses;
         return SUCCESS;
     }
-} board;  // Global board for game
+};
 
 // output string stream to decrease buffer usage
 std::ostringstream output;
 
-// vector of words for random word generation
-std::vector<std::string> word_set;
-
-// map of words for constant-time validation of guesses
-std::unordered_map<std::string, int> word_dict;
-
 // =============================================================================
 //  Function Prototypes
 
@@ -98,6 +142,37 @@ std::unordered_map<std::string, int> word_dict;
 
 inline void clear(std::ostream& output) { output << "\033[2J\033[1;1H"; }
 
+/// @brief Utility to move the cursor to the start of a line and erase
+/// everything from there to the end of the screen.
+///
+/// @param output : The output stream to position.
+/// @param line : The screen line, from 1.
+
+inline void move_to(std::ostream& output, int line) {
+    output << "\033[" << line << ";1H\033[J";
+}
+
+/// @brief Render one row of a board, caching the escape sequences once the
+/// row is filled, since a filled row never changes.
+///
+/// @param board : The board holding the row.
+/// @param row : The index of the row.
+///
+/// @return the rendered row, without a newline.
+
+template <int N, int G>
+const std::string& render_row(board_t<N, G>& board, int row);
+
+/// @brief Render the cells of one filled row from its feedback.
+///
+/// @param letters : The N letters of the guess.
+/// @param pattern : The feedback of the guess.
+///
+/// @return the escape sequences of the row, without a newline.
+
+template <int N>
+std::string render_cells(const char* letters, int pattern);
+
 /// @brief Insertion operator overload for printing a board_t
 ///
 /// @param output : The output stream to print to.
@@ -105,155 +180,1064 @@ inline void clear(std::ostream& output) { output << "\033[2J\033[1;1H"; }
 ///
 /// @return the output stream.
 
-std::ostream& operator<<(std::ostream& output, board_t& board);
+template <int N, int G>
+std::ostream& operator<<(std::ostream& output, board_t<N, G>& board);
 
-/// @brief Game loop for Wordle.
+/// @brief Load the dictionary of N-letter words and run the requested mode.
 ///
+/// @param argc : The number of command line arguments.
+/// @param argv : The command line arguments.
+///
+/// @return the exit status.
+
+template <int N>
+int run(int argc, char* argv[]);
+
+/// @brief Game loop for Wordle. Hints for the next guess are ranked in the
+/// background while the player types, and shown when '?' is entered.
+///
+/// @param dict : The words allowed as guesses.
 /// @param word : The target word to guess.
+/// @param log : Receives each guess on the board, its feedback and the time
+/// taken to enter it.
+
+template <int N, int G>
+void wordle(const dictionary_t<N>& dict, std::string& word, game_log_t& log);
+
+/// @brief Game loop for Absurdle: no target word is chosen, and each guess
+/// gets the feedback keeping the most words in play, until the player's
+/// guess is the only word left.
+///
+/// @param dict : The words allowed as guesses and in play.
+
+template <int N, int G>
+void absurdle(const dictionary_t<N>& dict);
+
+/// @brief Game loop for multi-board play: one guess is played on K boards
+/// at once, each with its own target word, drawn side by side.
+///
+/// @param dict : The words allowed as guesses and targets.
+/// @param engine : The engine the targets are drawn from.
+
+template <int N, int K, int G>
+void multiboard(const dictionary_t<N>& dict, engine_t& engine);
+
+/// @brief Analysis loop: ranks every allowed guess by the expected number of
+/// candidates left after it, and narrows the candidates as the player enters
+/// each guess and the feedback it received.
+///
+/// @param dict : The words allowed as guesses.
+
+void solver(const dictionary_t<>& dict);
+
+/// @brief Self-play benchmark: plays every word of the list as the answer
+/// and reports the guess-count distribution, failures and throughput.
+///
+/// @param dict : The words to play.
+/// @param strategy : The strategy choosing the guesses.
+///
+/// @return whether every game was won within the guess limit.
+
+bool bench(const dictionary_t<>& dict, strategy_t strategy);
+
+/// @brief Copy every packed word of the dictionary, in alphabetical order.
+///
+/// @param dict : The dictionary.
+///
+/// @return the packed words.
+
+std::vector<word_t> packed_words(const dictionary_t<>& dict);
+
+/// @brief Offline builder of the decision tree: searches the best guess for
+/// every feedback, resuming from the checkpoint of an interrupted build, and
+/// reports the guesses the tree takes over every answer.
+///
+/// @param dict : The words of the tree.
+/// @param beam : The number of guesses searched at each node.
+///
+/// @return whether the tree solves every answer and was written.
+
+bool tree_builder(const dictionary_t<>& dict, std::uint32_t beam);
+
+/// @brief Bot play from the decision tree: shows the tree's guess and
+/// follows the feedback the player enters, with no search.
+///
+/// @param dict : The words of the tree.
+///
+/// @return whether the tree was loaded.
+
+bool tree_walker(const dictionary_t<>& dict);
+
+/// @brief Replay a game log headlessly and report whether every game still
+/// plays out the same, and how fast.
+///
+/// @param dict : The dictionary answers are drawn from.
+/// @param path : The game log.
+///
+/// @return whether every game replayed alike.
+
+template <int N>
+bool replay(const dictionary_t<N>& dict, const std::string& path);
+
+/// @brief Statistics screen: win rate, streaks, guess distribution and the
+/// letters most often guessed in vain, read from the history header.
+///
+/// @param rescan : Whether to recompute the statistics from every game first.
+///
+/// @return whether the history was read.
 
-void wordle(std::string& word);
+bool stats(bool rescan);
 
-/// @brief Generate a random number between min and max.
+/// @brief Self-test: checks the bulk scorer against the reference scorer on
+/// hand-worked cases and on every pair of the word list, cut or repeated to
+/// each length from 4 to 7 letters.
 ///
-/// @param min : The lower bound of the generation range.
-/// @param max : The upper bound of the generation range.
+/// @param dict : The words to check.
 ///
-/// @return the generated value.
+/// @return whether every check passed.
+
+template <int N>
+bool selftest(const dictionary_t<N>& dict);
 
-int gen_random(int min, int max);
+int main(int argc, char* argv[]) {
+    // each word length is its own instantiation, with fixed-size loops
+    switch (list_length(DICT_FILE, WORD_FILE)) {
+        case 4: return run<4>(argc, argv);
+        case 5: return run<5>(argc, argv);
+        case 6: return run<6>(argc, argv);
+        case 7: return run<7>(argc, argv);
+    }
+
+    std::cerr << "Could not read 4 to 7 letter words from " << WORD_FILE
+              << " or " << DICT_FILE << ".\n";
+    return 1;
+}
 
-int main() {
-    std::ifstream word_file("wordslist.txt");
+template <int N>
+int run(int argc, char* argv[]) {
     std::string word;
+    dictionary_t<N> dict;  // words for random word generation, the solver
+                           // and read-only validation of guesses
+    std::string mode = argc > 1 ? argv[1] : "";  // requested run mode
+    bool rebuild = mode == "--build-dict";
+    std::uint64_t seed = std::random_device{}();  // seeds the game's engine
+    game_log_t log;                               // record of the game
+
+    // map the compiled word list, recompiling it if the text list changed
+    if (!load_dictionary(DICT_FILE, WORD_FILE, dict, rebuild) || !dict.count) {
+        std::cerr << "Could not load " << DICT_FILE << " or " << WORD_FILE
+                  << ".\n";
+        return 1;
+    }
+
+    if (rebuild) {
+        return 0;
+    } else if (mode == "--absurdle") {
+        absurdle<N, max_guesses<N>>(dict);
+        return 0;
+    } else if (mode == "--stats") {
+        return stats(argc > 2 && std::string(argv[2]) == "rescan") ? 0 : 1;
+    } else if (mode == "--selftest") {
+        return selftest(dict) ? 0 : 1;
+    } else if (mode == "--replay") {
+        return replay(dict, argc > 2 ? argv[2] : LOG_FILE) ? 0 : 1;
+    } else if (mode == "--multi") {
+        int boards = argc > 2 ? std::atoi(argv[2]) : 4;  // boards at once
+        engine_t engine(seed);
+
+        switch (boards) {
+            case 4:
+                multiboard<N, 4, multi_guesses<N, 4>>(dict, engine);
+                return 0;
+            case 8:
+                multiboard<N, 8, multi_guesses<N, 8>>(dict, engine);
+                return 0;
+            case 16:
+                multiboard<N, 16, multi_guesses<N, 16>>(dict, engine);
+                return 0;
+        }
+
+        std::cerr << "usage: Wordle --multi [4 | 8 | 16]\n";
+        return 1;
+    } else if (mode == "--serve") {
+        session_slab_t<N, max_guesses<N>> slab;
+        game_session_t<N, max_guesses<N>> session{slab, dict};
 
-    std::srand(0);
-    // std::srand(std::time(nullptr));
+        return serve_stream(session, STDIN_FILENO, STDOUT_FILENO) ? 0 : 1;
+    } else if (mode == "--socket" && argc > 2) {
+        session_slab_t<N, max_guesses<N>> slab;
 
-    // populate word list
-    while (word_file >> word) {
-        word_set.push_back(word);
-        word_dict[word] = 1;
+        return serve_socket(argv[2], [&] {
+            return game_session_t<N, max_guesses<N>>{slab, dict};
+        });
+    } else if (
+        mode == "--solve" || mode == "--bench" || mode == "--build-matrix" ||
+        mode == "--build-tree" || mode == "--tree"
+    ) {
+        // the solver, matrix, tree and benchmark work on 5-letter words only
+        if constexpr (N == WORD_LEN) {
+            strategy_t strategy = EXPECTED;
+            feedback_matrix_t matrix;
+            int beam = argc > 2 ? std::atoi(argv[2]) : TREE_BEAM;
+
+            if (mode == "--solve") {
+                solver(dict);
+                return 0;
+            } else if (mode == "--build-matrix") {
+                load_matrix(MATRIX_FILE, packed_words(dict), matrix, true);
+                return 0;
+            } else if (mode == "--tree") {
+                return tree_walker(dict) ? 0 : 1;
+            } else if (mode == "--build-tree" && beam < 1) {
+                std::cerr << "usage: Wordle --build-tree [beam]\n";
+                return 1;
+            } else if (mode == "--build-tree") {
+                return tree_builder(dict, (std::uint32_t)beam) ? 0 : 1;
+            } else if (argc > 2 && !parse_strategy(argv[2], strategy)) {
+                std::cerr << "usage: Wordle --bench [expected | entropy | "
+                          << "hard | frequency | sampled]\n";
+                return 1;
+            }
+
+            return bench(dict, strategy) ? 0 : 1;
+        } else {
+            std::cerr << mode << " needs " << WORD_LEN << "-letter words.\n";
+            return 1;
+        }
+    } else if (mode == "--daily") {
+        // the same word for everyone on the same date
+        if (!daily_seed(argc > 2 ? argv[2] : "", seed)) {
+            std::cerr << "usage: Wordle --daily [YYYY-MM-DD]\n";
+            return 1;
+        }
+    } else if (mode == "--seed") {
+        char* end = nullptr;  // first character not part of the seed
+
+        errno = 0;
+
+        // strtoull() would accept a sign
+        if (argc > 2 && std::isdigit((unsigned char)argv[2][0])) {
+            seed = std::strtoull(argv[2], &end, 10);
+        }
+
+        if (!end || *end || errno == ERANGE) {
+            std::cerr << "usage: Wordle --seed <number>\n";
+            return 1;
+        }
     }
 
     // choose random word
-    word = word_set.at((std::size_t)gen_random(0, (int)word_set.size()));
+    engine_t engine(seed);
+    auto answer = draw_word(dict, engine);
+
+    word = unpack<N>(answer);
+    start_log<N>(log, seed, answer);
 
-    wordle(word);
+    wordle<N, max_guesses<N>>(dict, word, log);
+
+    if (!append_log(LOG_FILE, log)) {
+        std::cerr << "Could not write " << LOG_FILE << ".\n";
+    }
+
+    history_record_t record = history_record<N>(log);  // the game's summary
+    history_header_t summary;                          // every game's
+
+    // only finished games count toward the statistics
+    if (
+        (record.won || record.turns == max_guesses<N>) &&
+        !append_history(HISTORY_FILE, record, summary)
+    ) {
+        std::cerr << "Could not write " << HISTORY_FILE << ".\n";
+    }
 
     return 0;
 }
 
-std::ostream& operator<<(std::ostream& output, board_t& board) {
+template <int N, int G>
+std::ostream& operator<<(std::ostream& output, board_t<N, G>& board) {
+    for (int row = 0; row < G; ++row) {
+        output << render_row(board, row) << '\n';
+    }
+
+    return output;
+}
+
+template <int N, int G>
+const std::string& render_row(board_t<N, G>& board, int row) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    static const std::string blank = [] {  // unfilled row
+        std::string cells;
+
+        for (int col = 0; col < N; ++col) {
+            cells += "| |";
+        }
+
+        return cells;
+    }();
+
+    if (row >= board.num_guesses) {
+        return blank;
+    } else if (!board.rows[row].empty()) {
+        return board.rows[row];
+    }
+
+    word_t goal{};            // packed goal word
+    word_t guess{};           // packed guess of this row
+
+    pack<N>(std::string(board.goal, N), goal);
+
+    if (!pack<N>(std::string(board.guesses[row], N), guess)) {
+        return blank;
+    }
+
+    board.rows[row] = render_cells<N>(board.guesses[row],
+                                      score<N>(guess, goal));
+    return board.rows[row];
+}
+
+template <int N>
+std::string render_cells(const char* letters, int pattern) {
     using namespace ansi;
-    for (int row = 0; row < MAX_GUESSES; ++row) {
-        std::unordered_map<char, int> lettersCorrect;
-        std::unordered_map<char, int> lettersMisplaced;
-
-        for (int col = 0; col < 5; ++col) {
-            output << '|';
-
-            char ch = board.guesses[row][col];
-
-            if (ch != '\0') {
-                // doesn't exist in goal word
-                if (
-                    board.letters[ch] == 0 ||
-                    board.letters[ch] - lettersCorrect[ch]
-                        - lettersMisplaced[ch] <= 0
-                ) {
-                    output << dk_gray << ch << reset;
-                } else {
-                    // matches position in goal word
-                    if (board.goal[col] == ch) {
-                        output << green << ch << reset;
-                        lettersCorrect[ch]++;
-                    } else if (
-                        board.letters[ch] - lettersCorrect[ch]
-                            - lettersMisplaced[ch] > 0
-                    ) {
-                        output << yellow << ch << reset;
-                        lettersMisplaced[ch]++;
-                    }
-                }
-            } else {
-                output << ' ';
-            }
 
-            output << '|';
+    std::ostringstream text;  // escape sequences of the row
+
+    for (int col = 0; col < N; ++col, pattern /= 3) {
+        text << '|';
+
+        char ch = letters[col];
+
+        if (pattern % 3 == 2) {
+            // matches position in goal word
+            text << green << ch << reset;
+        } else if (pattern % 3 == 1) {
+            // in goal word, elsewhere
+            text << yellow << ch << reset;
+        } else {
+            // doesn't exist in goal word (or all copies are accounted for)
+            text << dk_gray << ch << reset;
         }
-        output << '\n';
+
+        text << '|';
     }
 
-    return output;
+    return text.str();
 }
 
-void wordle(std::string& word) {
+template <int N, int G>
+void wordle(const dictionary_t<N>& dict, std::string& word, game_log_t& log) {
+    using clock = std::chrono::steady_clock;
+
     clear(std::cout);
 
+    board_t<N, G> board;      // the game's board
+    typename word_spec_t<N>::word_t goal{}, packed{};  // goal, last guess
     bool running = true;
     std::string guess = "";
+    std::string status = "";  // message shown above the prompt
+    hint_engine_t<N> hints(dict);                // ranks the next guesses
+    std::vector<turn_t<N>> history;              // guesses and feedback
+    std::unique_ptr<hint_result_t<N>> latest;    // newest hints taken
+    std::uint64_t pending = hints.submit(history);  // hints for this turn
 
-    board.clear();
     board.set_goal(word);
+    pack<N>(word, goal);
 
+    // full draw once; each turn then repaints only the new row and the lines
+    // below the board
     output << ansi::dk_gray << '[' << ansi::green << " W O R D L E "
            << ansi::dk_gray << ']' << ansi::reset << '\n';
-    output << board << '\n';
-    output << "Please enter a guess: ";
+    output << board << "\n\n";
+    output << "Please enter a guess (? for hints): ";
     std::cout << output.str() << std::flush;
     output.str("");
 
-    while (running) {
-        std::cin >> guess;
-        
-        clear(std::cout);
+    auto prompted = clock::now();  // when the current guess was asked for
+
+    while (running && std::cin >> guess) {
+        int added = board.num_guesses;  // row the guess fills, if accepted
 
         for (auto& ch : guess) {
             ch = (char)toupper(ch);
         }
 
-        if (guess == word) {
+        if (guess == "?") {
+            // whatever is ready now; the ranking never holds up input
+            if (auto fresh = hints.take()) {
+                latest = std::move(fresh);
+            }
+
+            if (!latest || latest->generation != pending) {
+                status = "Still thinking...";
+            } else {
+                std::ostringstream text;  // the hints, candidates in green
+
+                text << "Hints (" << latest->candidates << " words left):";
+
+                for (const hint_t<N>& hint : latest->best) {
+                    text << ' ' << (hint.candidate ? ansi::green
+                                                   : ansi::lt_gray)
+                         << unpack<N>(hint.guess) << ansi::reset;
+                }
+
+                status = text.str();
+            }
+        } else if (guess == word) {
             running = false;
-            clear(std::cout);
-            output << ansi::dk_gray << '[' << ansi::green << " W O R D L E "
-                   << ansi::dk_gray << ']' << ansi::reset << '\n';
             board.add_word(guess);
-            output << board << '\n';
-
-            output << "You guessed the word!\n\nThe word was " << word << '\n';
-        } else if (board.num_guesses + 1 == MAX_GUESSES) {
+            status = "You guessed the word!";
+        } else if (board.num_guesses + 1 == G) {
             running = false;
-
-            output << ansi::dk_gray << '[' << ansi::green << " W O R D L E "
-                   << ansi::dk_gray << ']' << ansi::reset << '\n';
             board.add_word(guess);
-            output << board << '\n';
+            status = "You ran out of guesses!";
+        } else if (!dict.contains(guess)) {
+            status = "That wasn't a valid guess.";
+        } else {
+            board.add_word(guess);
+            status = "";
+        }
 
-            output << "You ran out of guesses!\n\nThe word was " << word
-                   << '\n';
+        if (added < board.num_guesses) {
+            output << "\033[" << BOARD_LINE + added << ";1H"
+                   << render_row(board, added);
+
+            if (pack<N>(guess, packed)) {
+                auto taken = std::chrono::duration_cast<
+                    std::chrono::milliseconds>(clock::now() - prompted);
+
+                log.guesses.push_back({packed, (std::uint32_t)taken.count(),
+                                       score<N>(packed, goal), 0});
+                history.push_back({packed, score<N>(packed, goal)});
+
+                // cancels the ranking for the last turn, if still running
+                if (running) {
+                    pending = hints.submit(history);
+                }
+            }
+        }
+
+        move_to(output, BOARD_LINE + G + 1);
+        output << status << '\n';
+
+        if (running) {
+            output << "Please enter a guess (? for hints): ";
         } else {
+            output << "\nThe word was " << word << '\n';
+        }
+
+        std::cout << output.str() << std::flush;
+        output.str("");
+        prompted = clock::now();
+    }
+}
+
+template <int N, int G>
+void absurdle(const dictionary_t<N>& dict) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    std::vector<word_t> candidates(dict.words, dict.words + dict.count);
+    std::vector<typename word_spec_t<N>::pattern_t> scratch;
+    board_t<N, G> board;      // the game's board
+    bool running = true;
+    std::string guess = "";
+    std::string status = "";  // message shown above the prompt
+
+    clear(std::cout);
+
+    output << ansi::dk_gray << '[' << ansi::green << " A B S U R D L E "
+           << ansi::dk_gray << ']' << ansi::reset << '\n';
+    output << board << "\n\n";
+    output << "Please enter a guess: ";
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    while (running && std::cin >> guess) {
+        int added = board.num_guesses;  // row the guess fills, if accepted
+        word_t packed{};
+
+        for (auto& ch : guess) {
+            ch = (char)toupper(ch);
+        }
+
+        if (!pack<N>(guess, packed) || !dict.contains(packed)) {
+            status = "That wasn't a valid guess.";
+        } else {
+            auto pattern = absurdle_feedback<N>(packed, candidates, scratch);
+
+            // every remaining candidate gives every row so far its feedback,
+            // so any of them colors the new row as the adversary chose
+            std::string goal = unpack<N>(candidates[0]);
 
-            output << ansi::dk_gray << '[' << ansi::green << " W O R D L E "
-                   << ansi::dk_gray << ']' << ansi::reset << '\n';
+            board.set_goal(goal);
+            board.add_word(guess);
 
-            if (guess.length() != 5 || word_dict[guess] == 0) {
-                output << board << '\n';
-                output << "That wasn't a valid guess.\n";
+            if (pattern == word_spec_t<N>::all_green) {
+                running = false;
+                status = "You cornered the word!";
+            } else if (board.num_guesses == G) {
+                running = false;
+                status = "You ran out of guesses!";
             } else {
+                status = candidates.size() == 1 ? "1 word remains."
+                         : std::to_string(candidates.size()) +
+                               " words remain.";
+            }
+        }
+
+        if (added < board.num_guesses) {
+            output << "\033[" << BOARD_LINE + added << ";1H"
+                   << render_row(board, added);
+        }
+
+        move_to(output, BOARD_LINE + G + 1);
+        output << status << '\n';
+
+        if (running) {
+            output << "Please enter a guess: ";
+        } else {
+            output << "\nThe word was " << unpack<N>(candidates[0]) << '\n';
+        }
+
+        std::cout << output.str() << std::flush;
+        output.str("");
+    }
+}
+
+template <int N, int K, int G>
+void multiboard(const dictionary_t<N>& dict, engine_t& engine) {
+    using word_t = typename word_spec_t<N>::word_t;
+
+    const int ACROSS = K <= 8 ? 4 : 8;            // boards side by side
+    const int BANDS = (K + ACROSS - 1) / ACROSS;  // rows of boards
+
+    board_t<N, G> boards[K];                     // one board per target
+    word_t goals[K];                             // packed targets
+    typename word_spec_t<N>::pattern_t patterns[K];
+    bool done[K] {};                             // boards guessed
+    int solved = 0;                              // number of boards guessed
+    int turn = 0;                                // guesses made
+    bool running = true;
+    std::string guess = "";
+    std::string status = "";  // message shown above the prompt
+
+    // distinct targets
+    for (int k = 0; k < K; ++k) {
+        goals[k] = draw_word(dict, engine);
+
+        if (std::find(goals, goals + k, goals[k]) != goals + k) {
+            --k;
+            continue;
+        }
+
+        std::string goal = unpack<N>(goals[k]);
+        boards[k].set_goal(goal);
+    }
+
+    // one screen line of a band: row 'row' of each of its boards
+    auto band_line = [&](int band, int row) {
+        for (int k = band * ACROSS; k < std::min(K, (band + 1) * ACROSS); ++k) {
+            output << render_row(boards[k], row) << "  ";
+        }
+    };
+
+    clear(std::cout);
+
+    output << ansi::dk_gray << '[' << ansi::green << ' ' << K
+           << " - B O A R D " << ansi::dk_gray << ']' << ansi::reset << '\n';
+
+    for (int band = 0; band < BANDS; ++band) {
+        for (int row = 0; row < G; ++row) {
+            band_line(band, row);
+            output << '\n';
+        }
+
+        output << '\n';
+    }
+
+    output << "\nPlease enter a guess: ";
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    while (running && std::cin >> guess) {
+        word_t packed{};
+
+        for (auto& ch : guess) {
+            ch = (char)toupper(ch);
+        }
+
+        if (!pack<N>(guess, packed) || !dict.contains(packed)) {
+            status = "That wasn't a valid guess.";
+        } else {
+            // one kernel call scores the guess against every target
+            score_many<N>(packed, goals, K, patterns);
+
+            for (int k = 0; k < K; ++k) {
+                board_t<N, G>& board = boards[k];
+
+                if (done[k]) {
+                    continue;
+                }
+
+                // the batch already has the feedback: fill the row cache
                 board.add_word(guess);
-                output << board << '\n';
+                board.rows[turn] = render_cells<N>(board.guesses[turn],
+                                                   patterns[k]);
+
+                if (patterns[k] == word_spec_t<N>::all_green) {
+                    done[k] = true;
+                    ++solved;
+                }
             }
 
+            // the new row is at the same height on every unsolved board
+            for (int band = 0; band < BANDS; ++band) {
+                output << "\033[" << BOARD_LINE + band * (G + 1) + turn
+                       << ";1H";
+                band_line(band, turn);
+            }
+
+            ++turn;
+
+            if (solved == K) {
+                running = false;
+                status = "You guessed every word!";
+            } else if (turn == G) {
+                running = false;
+                status = "You ran out of guesses!";
+            } else {
+                status = std::to_string(K - solved) + " words to go.";
+            }
+        }
+
+        move_to(output, BOARD_LINE + BANDS * (G + 1));
+        output << status << '\n';
+
+        if (running) {
             output << "Please enter a guess: ";
+        } else {
+            output << "\nThe words were";
+
+            for (int k = 0; k < K; ++k) {
+                output << ' ' << unpack<N>(goals[k]);
+            }
+
+            output << '\n';
+        }
+
+        std::cout << output.str() << std::flush;
+        output.str("");
+    }
+}
+
+void solver(const dictionary_t<>& dict) {
+    std::vector<word_t> guesses = packed_words(dict);  // every allowed guess
+    candidate_set_t candidates;             // words which could be the answer
+    feedback_matrix_t matrix;               // feedback of every pair
+    std::string guess, feedback;
+    word_t packed{};
+    pattern_t pattern{};
+
+    load_matrix(MATRIX_FILE, guesses, matrix);
+    candidates.fill(guesses.size());
+
+    while (candidates.count() > 1) {
+        output << ansi::dk_gray << '[' << ansi::green << " S O L V E R "
+               << ansi::dk_gray << ']' << ansi::reset << '\n'
+               << candidates.count() << " candidates remaining.\n\n";
+
+        for (
+            auto& rank :
+            rank_guesses(matrix, candidates.indices(), SHOW_GUESSES)
+        ) {
+            output << "  " << (rank.candidate ? ansi::green : ansi::lt_gray)
+                   << unpack(guesses[rank.guess]) << ansi::reset
+                   << std::fixed << std::setprecision(2)
+                   << "  " << std::setw(8) << rank.expected << " left"
+                   << "  " << std::setw(5) << rank.entropy << " bits\n";
+        }
+
+        output << "\nEnter a guess and its feedback (e.g. CRANE g.y..): ";
+        std::cout << output.str() << std::flush;
+        output.str("");
+
+        if (!(std::cin >> guess >> feedback)) {
+            return;
+        }
+
+        pack(guess, packed);
+
+        auto index = std::find(guesses.begin(), guesses.end(), packed);
+
+        if (
+            guess.length() != 5 || index == guesses.end() ||
+            !parse_pattern(feedback, pattern)
+        ) {
+            output << "That wasn't a valid guess and feedback.\n\n";
+            continue;
+        }
+
+        apply_feedback(matrix, candidates,
+                       (std::uint32_t)(index - guesses.begin()), pattern);
+        output << '\n';
+    }
+
+    if (!candidates.count()) {
+        output << "No word matches that feedback.\n";
+    } else {
+        output << "The word is " << ansi::green
+               << unpack(dict.words[candidates.indices()[0]])
+               << ansi::reset << ".\n";
+    }
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+}
+
+bool bench(const dictionary_t<>& dict, strategy_t strategy) {
+    static const char* NAMES[] = {"expected", "entropy", "hard", "frequency",
+                                  "sampled"};
+
+    feedback_matrix_t matrix;  // feedback of every pair
+    std::uint64_t failures = 0;
+    std::uint64_t total = 0;   // guesses over the games won
+
+    std::vector<word_t> words = packed_words(dict);
+
+    load_matrix(MATRIX_FILE, words, matrix);
+
+    bench_result_t result = run_bench(matrix, words, strategy);
+
+    output << ansi::dk_gray << '[' << ansi::green << " B E N C H "
+           << ansi::dk_gray << ']' << ansi::reset << ' '
+           << NAMES[strategy] << ", " << result.games << " games\n\n";
+
+    for (int n = 1; n <= BENCH_TURN_CAP; ++n) {
+        if (result.turns[n]) {
+            output << "  " << std::setw(2) << n << " guesses  "
+                   << std::setw(6) << result.turns[n] << '\n';
+        }
+
+        total += result.turns[n] * (std::uint64_t)n;
+        failures += n > max_guesses<WORD_LEN> ? result.turns[n] : 0;
+    }
+
+    failures += result.turns[0];
+
+    std::uint64_t played = result.games - result.turns[0];  // not abandoned
+
+    output << std::fixed << std::setprecision(3)
+           << "\n  abandoned  " << std::setw(6) << result.turns[0]
+           << "\n  failures   " << std::setw(6) << failures
+           << "  (more than " << max_guesses<WORD_LEN> << " guesses)"
+           << "\n  average    " << std::setw(10);
+
+    // no game was played to the end: an empty list, or every one stopped
+    if (played) {
+        output << (double)total / (double)played;
+    } else {
+        output << '-';
+    }
+
+    output << " guesses"
+           << "\n  wall time  " << std::setw(10) << result.seconds << " s"
+           << "\n  rate       " << std::setw(10)
+           << (double)result.games / result.seconds << " games/s\n";
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    return failures == 0;
+}
+
+std::vector<word_t> packed_words(const dictionary_t<>& dict) {
+    return std::vector<word_t>(dict.words, dict.words + dict.count);
+}
+
+bool tree_builder(const dictionary_t<>& dict, std::uint32_t beam) {
+    std::vector<word_t> words = packed_words(dict);  // the tree's words
+    feedback_matrix_t matrix;                        // feedback of every pair
+    tree_t tree;
+    std::uint64_t hash = hash_words(words);
+    int deepest = 0;                                 // most guesses taken
+
+    load_matrix(MATRIX_FILE, words, matrix);
+
+    output << ansi::dk_gray << '[' << ansi::green << " T R E E "
+           << ansi::dk_gray << ']' << ansi::reset << ' ' << words.size()
+           << " words, beam " << beam << '\n';
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    if (!build_tree(matrix, hash, beam, TREE_CHECKPOINT, tree)) {
+        std::cerr << "Some answers need more than " << TREE_DEPTH_CAP
+                  << " guesses; try a wider beam.\n";
+        return false;
+    }
+
+    // walk the tree to every answer, as a check of the tree itself
+    for (std::uint32_t answer = 0; answer < words.size(); ++answer) {
+        std::uint32_t node = 0;
+        int turns = 1;
+
+        for (; tree.nodes[node].guess != answer; ++turns) {
+            node = tree.child(node, matrix.at(tree.nodes[node].guess, answer));
+
+            if (node == NO_NODE) {
+                std::cerr << "The tree loses " << unpack(words[answer])
+                          << ".\n";
+                return false;
+            }
         }
 
+        deepest = std::max(deepest, turns);
+    }
+
+    output << std::fixed << std::setprecision(3)
+           << "\n  opening    " << std::setw(10)
+           << unpack(words[tree.nodes[0].guess])
+           << "\n  average    " << std::setw(10)
+           << (double)tree.cost / (double)words.size() << " guesses"
+           << "\n  worst      " << std::setw(10) << deepest << " guesses"
+           << "\n  nodes      " << std::setw(10) << tree.nodes.size() << '\n';
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    if (!write_tree(TREE_FILE, tree, (std::uint32_t)words.size(), hash,
+                    beam)) {
+        std::cerr << "Could not write " << TREE_FILE << ".\n";
+        return false;
+    }
+
+    std::remove(TREE_CHECKPOINT);
+    return true;
+}
+
+bool tree_walker(const dictionary_t<>& dict) {
+    std::vector<word_t> words = packed_words(dict);  // the tree's words
+    tree_t tree;
+    std::uint32_t node = 0;                          // the tree's position
+    std::string feedback;
+    pattern_t pattern{};
+
+    if (!read_tree(TREE_FILE, (std::uint32_t)words.size(), hash_words(words),
+                   tree)) {
+        std::cerr << "Could not read " << TREE_FILE << " (missing, stale or "
+                  << "corrupt); run ./Wordle --build-tree first.\n";
+        return false;
+    }
+
+    output << ansi::dk_gray << '[' << ansi::green << " T R E E "
+           << ansi::dk_gray << ']' << ansi::reset << std::fixed
+           << std::setprecision(3) << ' '
+           << (double)tree.cost / (double)words.size()
+           << " guesses on average\n\n";
+
+    for (int turn = 1; node != NO_NODE; ++turn) {
+        output << "Guess " << turn << ": " << ansi::green
+               << unpack(words[tree.nodes[node].guess]) << ansi::reset
+               << "\nEnter its feedback (e.g. g.y..): ";
         std::cout << output.str() << std::flush;
         output.str("");
+
+        if (!(std::cin >> feedback)) {
+            break;
+        } else if (!parse_pattern(feedback, pattern)) {
+            output << "That wasn't a valid feedback.\n\n";
+            --turn;
+            continue;
+        } else if (pattern == ALL_GREEN) {
+            output << "Solved in " << turn << " guesses.\n";
+            break;
+        }
+
+        node = tree.child(node, pattern);
+        output << '\n';
+    }
+
+    if (node == NO_NODE) {
+        output << "No word matches that feedback.\n";
     }
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    return true;
 }
 
-int gen_random(int min, int max) {
-    std::random_device rd;
-    std::uniform_int_distribution<int> dist(min, max);
-    return dist(rd);
+bool stats(bool rescan) {
+    const int SHOW_LETTERS = 5;  // letters listed by miss rate
+
+    history_header_t summary;    // statistics of every finished game
+    std::uint64_t most = 1;      // largest guess-count tally, for the bars
+    int letters[26];             // letters, by miss rate
+
+    if (
+        !(rescan ? rescan_history(HISTORY_FILE, summary)
+                 : read_history(HISTORY_FILE, summary))
+    ) {
+        std::cerr << "Could not read " << HISTORY_FILE << ".\n";
+        return false;
+    }
+
+    output << ansi::dk_gray << '[' << ansi::green << " S T A T S "
+           << ansi::dk_gray << ']' << ansi::reset << ' ' << summary.games
+           << " games\n\n";
+
+    output << std::fixed << std::setprecision(1)
+           << "  won        " << std::setw(6) << summary.wins << "  ("
+           << (summary.games ? 100.0 * (double)summary.wins /
+                                   (double)summary.games : 0.0)
+           << "%)\n  streak     " << std::setw(6) << summary.streak
+           << "\n  best       " << std::setw(6) << summary.best_streak
+           << "\n\n";
+
+    for (int n = 0; n < HISTORY_TURNS; ++n) {
+        most = std::max(most, summary.turns[n]);
+    }
+
+    for (int n = 1; n < HISTORY_TURNS; ++n) {
+        if (summary.turns[n]) {
+            output << "  " << std::setw(2) << n << " guesses  "
+                   << std::setw(6) << summary.turns[n] << "  "
+                   << std::string(1 + 40 * summary.turns[n] / most, '#')
+                   << '\n';
+        }
+    }
+
+    output << "     lost    " << std::setw(6) << summary.turns[0] << "\n\n";
+
+    // miss rate: share of the games a letter was guessed in where the
+    // answer did not have it
+    auto rate = [&summary](int letter) {
+        return summary.guessed[letter]
+                   ? (double)summary.missed[letter] /
+                         (double)summary.guessed[letter]
+                   : 0.0;
+    };
+
+    for (int letter = 0; letter < 26; ++letter) {
+        letters[letter] = letter;
+    }
+
+    std::stable_sort(letters, letters + 26, [&rate](int lhs, int rhs) {
+        return rate(lhs) > rate(rhs);
+    });
+
+    output << "  most missed";
+
+    for (int i = 0; i < SHOW_LETTERS && summary.guessed[letters[i]]; ++i) {
+        output << "  " << (char)('A' + letters[i]) << ' '
+               << 100.0 * rate(letters[i]) << '%';
+    }
+
+    output << '\n';
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    return true;
+}
+
+template <int N>
+bool replay(const dictionary_t<N>& dict, const std::string& path) {
+    replay_result_t result;  // tally of the replayed games
+
+    if (!replay_log(path, dict, result)) {
+        std::cerr << "Could not read " << path << " to the end.\n";
+        return false;
+    }
+
+    output << ansi::dk_gray << '[' << ansi::green << " R E P L A Y "
+           << ansi::dk_gray << ']' << ansi::reset << ' ' << path << ", "
+           << result.games << " games\n";
+
+    output << std::fixed << std::setprecision(3)
+           << "\n  guesses    " << std::setw(6) << result.guesses
+           << "\n  won        " << std::setw(6) << result.won
+           << "\n  skipped    " << std::setw(6) << result.skipped
+           << "  (other word lengths)"
+           << "\n  mismatches " << std::setw(6) << result.mismatches
+           << "\n  wall time  " << std::setw(10) << result.seconds << " s"
+           << "\n  rate       " << std::setw(10)
+           << (double)result.games / result.seconds << " games/s\n";
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    return result.mismatches == 0;
+}
+
+template <int N>
+bool selftest(const dictionary_t<N>& dict) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string> texts;  // the word list as text
+    bool passed = true;
+    auto start = clock::now();
+
+    for (std::size_t i = 0; i < dict.count; ++i) {
+        texts.push_back(unpack<N>(dict.words[i]));
+    }
+
+    output << ansi::dk_gray << '[' << ansi::green << " S E L F T E S T "
+           << ansi::dk_gray << ']' << ansi::reset << ' ' << dict.count
+           << " words\n\n";
+
+    // one line per word length
+    auto check = [&](auto length) {
+        constexpr int L = decltype(length)::value;
+        check_result_t result;
+
+        check_cases<L>(result);
+        check_scoring<L>(stretch_words<L>(texts), result);
+
+        output << "  " << L << " letters  " << std::setw(10) << result.pairs
+               << " pairs  " << std::setw(4) << result.mismatches
+               << " mismatches  ("
+               << (bulk_avx2<L>() ? "AVX2 and scalar" : "scalar") << ")\n";
+
+        if (result.mismatches) {
+            output << "    " << result.first << '\n';
+            passed = false;
+        }
+    };
+
+    check(std::integral_constant<int, 4>());
+    check(std::integral_constant<int, 5>());
+    check(std::integral_constant<int, 6>());
+    check(std::integral_constant<int, 7>());
+
+    // the sampler, on every third word: too many to be rated exactly
+    using word_t = typename word_spec_t<N>::word_t;
+    std::vector<word_t> guesses(dict.words, dict.words + dict.count);
+    std::vector<word_t> candidates;
+    sampling_result_t sampling;
+
+    for (std::size_t i = 0; i < dict.count; i += 3) {
+        candidates.push_back(dict.words[i]);
+    }
+
+    if (candidates.size() > SAMPLE_BATCH * SAMPLE_MIN_BATCHES) {
+        check_sampling<N>(guesses, candidates, sampling);
+
+        output << std::fixed << std::setprecision(2) << "\n  sampling   "
+               << std::setw(6) << candidates.size() << " candidates  bias "
+               << sampling.bias << " se  covered " << sampling.covered << '/'
+               << sampling.rated << "  best kept " << sampling.found << '/'
+               << sampling.runs << '\n';
+
+        passed = passed && sampling.bias <= BIAS_LIMIT &&
+                 sampling.covered >= SAMPLE_COVERAGE * sampling.rated &&
+                 sampling.found == sampling.runs;
+    }
+
+    output << std::fixed << std::setprecision(3)
+           << "\n  wall time  " << std::setw(10)
+           << std::chrono::duration<double>(clock::now() - start).count()
+           << " s\n  result     " << (passed ? "passed" : "FAILED") << '\n';
+
+    std::cout << output.str() << std::flush;
+    output.str("");
+
+    return passed;
 }
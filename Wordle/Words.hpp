@@ -0,0 +1,168 @@
+/// @file Words.hpp
+/// @author William Simpson <simpsw1@unlv.nevada.edu>
+/// @date 10-20-2022
+/// @brief Packed word and feedback pattern encodings for Wordle.cpp.
+///
+/// @note A word is packed 5 bits per letter ('A' -> 0 ... 'Z' -> 25), first
+/// letter in the lowest bits. Feedback is a base-3 number with one digit per
+/// position (0 -> gray, 1 -> yellow, 2 -> green), first position lowest.
+/// Everything is a template on the word length N, so each length gets its own
+/// fixed-size loops; the plain names are the classic 5-letter instances.
+
+#ifndef WORDS_HPP_
+#define WORDS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// =============================================================================
+//  Type and Constant Definitions
+
+/// @brief Compute a power of 3.
+///
+/// @param n : The exponent.
+///
+/// @return 3 ^ n.
+
+constexpr int pow3(int n) { return n ? 3 * pow3(n - 1) : 1; }
+
+template <int N>
+struct word_spec_t {
+    static_assert(N >= 1 && N <= 10, "feedback must fit in 16 bits");
+
+    // packed word of N letters
+    using word_t = std::conditional_t<5 * N <= 32, std::uint32_t,
+                                      std::uint64_t>;
+    // base-3 feedback of one guess
+    using pattern_t = std::conditional_t<pow3(N) <= 256, std::uint8_t,
+                                         std::uint16_t>;
+
+    static const int patterns = pow3(N);              // 3 ^ N patterns
+    static const pattern_t all_green = pow3(N) - 1;   // a correct guess
+};
+
+const int WORD_LEN = 5;                 // letters per word, classic game
+
+using word_t = word_spec_t<WORD_LEN>::word_t;        // packed 5-letter word
+using pattern_t = word_spec_t<WORD_LEN>::pattern_t;  // its feedback
+
+const int NUM_PATTERNS = word_spec_t<WORD_LEN>::patterns;   // 243
+const pattern_t ALL_GREEN = word_spec_t<WORD_LEN>::all_green;
+
+// =============================================================================
+//  Encoding
+
+/// @brief Retrieve one letter of a packed word.
+///
+/// @param word : The packed word.
+/// @param pos : The position of the letter, from 0.
+///
+/// @return the letter index, 0 for 'A' through 25 for 'Z'.
+
+template <int N = WORD_LEN>
+inline int letter_at(typename word_spec_t<N>::word_t word, int pos) {
+    return (int)((word >> (5 * pos)) & 31);
+}
+
+/// @brief Pack a word of N letters.
+///
+/// @param text : The word to pack, in either case.
+/// @param word : Receives the packed word.
+///
+/// @return whether the text was exactly N letters.
+
+template <int N = WORD_LEN>
+inline bool pack(const std::string& text,
+                 typename word_spec_t<N>::word_t& word) {
+    using packed_t = typename word_spec_t<N>::word_t;
+
+    if (text.length() != N) {
+        return false;
+    }
+
+    word = 0;
+
+    for (int i = 0; i < N; ++i) {
+        char ch = text[i];
+
+        if (ch >= 'a' && ch <= 'z') {
+            ch = (char)(ch - 'a' + 'A');
+        } else if (ch < 'A' || ch > 'Z') {
+            return false;
+        }
+
+        word |= (packed_t)(ch - 'A') << (5 * i);
+    }
+
+    return true;
+}
+
+/// @brief Unpack a word into its uppercase letters.
+///
+/// @param word : The packed word.
+///
+/// @return the word as text.
+
+template <int N = WORD_LEN>
+inline std::string unpack(typename word_spec_t<N>::word_t word) {
+    std::string text(N, ' ');
+
+    for (int i = 0; i < N; ++i) {
+        text[i] = (char)('A' + letter_at<N>(word, i));
+    }
+
+    return text;
+}
+
+// =============================================================================
+//  Feedback Patterns
+
+/// @brief Read a feedback pattern typed by the player.
+///
+/// @param text : One character per position: 'g' or '2' for green, 'y' or
+/// '1' for yellow, and '.', '-', 'x' or '0' for gray.
+/// @param pattern : Receives the pattern.
+///
+/// @return whether the text was a valid pattern.
+
+template <int N = WORD_LEN>
+inline bool parse_pattern(const std::string& text,
+                          typename word_spec_t<N>::pattern_t& pattern) {
+    if (text.length() != N) {
+        return false;
+    }
+
+    int code = 0;
+
+    for (int i = N - 1; i >= 0; --i) {
+        int digit;
+
+        switch (text[i]) {
+            case 'g': case 'G': case '2': digit = 2; break;
+            case 'y': case 'Y': case '1': digit = 1; break;
+            case '.': case '-': case 'x': case 'X': case '0': digit = 0; break;
+            default: return false;
+        }
+
+        code = code * 3 + digit;
+    }
+
+    pattern = (typename word_spec_t<N>::pattern_t)code;
+    return true;
+}
+
+/// @brief Write a feedback pattern as text.
+///
+/// @param pattern : The feedback pattern.
+/// @param text : Receives one character per position ('g' green, 'y'
+/// yellow, '.' gray), appended.
+
+template <int N = WORD_LEN>
+inline void format_pattern(int pattern, std::string& text) {
+    for (int i = 0; i < N; ++i, pattern /= 3) {
+        text += ".yg"[pattern % 3];
+    }
+}
+
+#endif  // WORDS_HPP_